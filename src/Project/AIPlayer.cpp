@@ -1,15 +1,79 @@
 #include "AIPlayer.h"
+#include "Zobrist.h"
+#include "PerfectPlayTable.h"
+
+namespace {
+// Move ordering keys, highest tried first. Below the killers a move's key
+// is its history score * 128 plus its cell prior (at most 4 * 16 lines).
+constexpr int WIN_KEY = 1 << 30;
+constexpr int BLOCK_KEY = 1 << 29;
+constexpr int KILLER_KEY = 1 << 28;
+constexpr int HISTORY_LIMIT = 1 << 20;
+}
 
-AIPlayer::AIPlayer(Difficulty diff) : difficulty(diff), rng(std::random_device{}())
+AIPlayer::AIPlayer(Difficulty diff, uint64_t seed)
+    : difficulty(diff), cancelRequested(false), timeLimitMs(1000), threadCount(1),
+      parallelMode(ROOT_SPLIT), engine(MINIMAX), playoutBudget(20000), moveOrdering(true), rng(seed), side('O'), expandedNodes(0), searchedChildren(0), tableSize(0),
+      tableWinLength(0)
 {
+    setSeed(seed);
+}
+
+void AIPlayer::setSeed(uint64_t seed)
+{
+    rng.seed(seed);
+    mctsEngine.setSeed(Zobrist::splitmix64(seed));
 }
 
 std::pair<int, int> AIPlayer::getMove(Board* board)
+{
+    lastStats = SearchStats();
+    expandedNodes = 0;
+    searchedChildren = 0;
+    threadPool.resize(threadCount);
+    orderingTables.resize(threadPool.size());
+    for (OrderingTables& tables : orderingTables) {
+        tables.clear();
+    }
+    int limit = timeLimitMs;
+    auto start = std::chrono::steady_clock::now();
+    deadline = limit > 0 ? start + std::chrono::milliseconds(limit)
+                         : std::chrono::steady_clock::time_point::max();
+
+    // Hashes only identify positions within one board variant
+    if (board->getSize() != tableSize || board->getWinLength() != tableWinLength) {
+        transpositionTable.clear();
+        mctsEngine.clear();
+        tableSize = board->getSize();
+        tableWinLength = board->getWinLength();
+        computeCellPriors(*board);
+    }
+
+    // Searches play and take back moves on one private copy. Minimax looks
+    // positions up by canonical hash, so only it keeps every symmetry's hash.
+    Board searchBoard = *board;
+    searchBoard.setSymmetryHashing(engine == MINIMAX);
+    std::pair<int, int> move = chooseMove(&searchBoard);
+
+    lastStats.wallTimeMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (expandedNodes > 0) {
+        lastStats.branchingFactor = double(searchedChildren) / expandedNodes;
+    }
+
+    // A cancelled search only has partial scores; never play on them
+    if (isCancelled()) {
+        return {-1, -1};
+    }
+    return move;
+}
+
+std::pair<int, int> AIPlayer::chooseMove(Board* board)
 {
     switch (difficulty) {
     case EASY:
         // Easy mode: 60% strategic, 40% random
-        if (rng() % 10 < 6) {
+        if (rng.percent(60)) {
             return getBestMove(board);
         } else {
             return getRandomMove(board);
@@ -35,42 +99,40 @@ std::pair<int, int> AIPlayer::getMediumMove(Board* board)
     // 4. 30% of the time make suboptimal moves (increased from 15%)
     // 5. Occasionally make "human-like" mistakes
 
-    auto availableMoves = board->getAvailableMoves();
-    if (availableMoves.empty()) {
+    // Wins and blocks come from one pass over the root moves; the search
+    // that ranks them runs at most once, and only when a policy needs it
+    std::vector<RootMove> moves = analyzeRoot(board);
+    if (moves.empty()) {
         return {-1, -1};
     }
 
     // Always check for immediate win first
-    for (const auto& move : availableMoves) {
-        Board testBoard = *board;
-        if (testBoard.makeMove(move.first, move.second, 'O')) {
-            if (testBoard.checkWin('O')) {
-                return move; // Always take the win
-            }
+    for (const RootMove& root : moves) {
+        if (root.wins) {
+            return root.move; // Always take the win
         }
     }
 
     // 90% chance to block opponent's win (10% chance to miss!)
     if (!shouldMissBlock()) {
-        for (const auto& move : availableMoves) {
-            Board testBoard = *board;
-            if (testBoard.makeMove(move.first, move.second, 'X')) {
-                if (testBoard.checkWin('X')) {
-                    return move; // Block the win
-                }
+        for (const RootMove& root : moves) {
+            if (root.blocks) {
+                return root.move; // Block the win
             }
         }
     }
 
     // 70% optimal play, 30% suboptimal (more mistakes than before)
     if (!shouldMakeMistake()) {
-        return getBestMove(board);
+        rankRootMoves(board, moves);
+        return moves.front().move;
     } else {
         // Make more varied mistakes - choose from top 4 moves or even random sometimes
         if (shouldMakeRandomMistake()) {
             return getRandomMove(board); // 5% chance for completely random move
         } else {
-            return getSuboptimalMove(board); // Choose from 2nd-4th best moves
+            rankRootMoves(board, moves);
+            return getSuboptimalMove(board, moves); // Choose from 2nd-4th best moves
         }
     }
 }
@@ -78,49 +140,33 @@ std::pair<int, int> AIPlayer::getMediumMove(Board* board)
 bool AIPlayer::shouldMakeMistake()
 {
     // 30% chance to make a suboptimal move (increased from 15%)
-    return (rng() % 100) < 30;
+    return rng.percent(30);
 }
 
 bool AIPlayer::shouldMissBlock()
 {
     // 10% chance to miss blocking a winning move (new vulnerability!)
-    return (rng() % 100) < 10;
+    return rng.percent(10);
 }
 
 bool AIPlayer::shouldMakeRandomMistake()
 {
     // 5% chance to make a completely random move
-    return (rng() % 100) < 5;
+    return rng.percent(5);
 }
 
-std::pair<int, int> AIPlayer::getSuboptimalMove(Board* board)
+std::pair<int, int> AIPlayer::getSuboptimalMove(Board* board, const std::vector<RootMove>& ranked)
 {
-    auto availableMoves = board->getAvailableMoves();
-    std::vector<std::pair<std::pair<int, int>, int>> moveScores;
-
-    for (const auto& move : availableMoves) {
-        Board testBoard = *board;
-        if (testBoard.makeMove(move.first, move.second, 'O')) {
-            int score = minimax(testBoard, 0, false, INT_MIN, INT_MAX);
-            moveScores.push_back({move, score});
-        }
-    }
-
-    // Sort moves by score (best first)
-    std::sort(moveScores.begin(), moveScores.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
-
     // Choose from 2nd to 4th best moves (skip the best move)
     int startIndex = 1; // Skip best move
-    int endIndex = std::min(4, static_cast<int>(moveScores.size()));
+    int endIndex = std::min(4, static_cast<int>(ranked.size()));
 
     if (startIndex >= endIndex) {
         // Fallback to random if not enough moves
         return getRandomMove(board);
     }
 
-    std::uniform_int_distribution<> dist(startIndex, endIndex - 1);
-    return moveScores[dist(rng)].first;
+    return ranked[startIndex + rng.below(endIndex - startIndex)].move;
 }
 
 
@@ -128,112 +174,535 @@ std::pair<int, int> AIPlayer::getSuboptimalMove(Board* board)
 
 std::pair<int, int> AIPlayer::getBestMove(Board* board)
 {
-    int bestScore = INT_MIN;
-    std::pair<int, int> bestMove = {-1, -1};
+    // Hard mode on a position reachable in play: answer from the solved table.
+    // Its values are O's, so X, which would pick its slowest win from them,
+    // always searches.
+    if (difficulty == HARD && board->isClassic() && side == 'O') {
+        uint16_t xMask = board->getMask('X');
+        uint16_t oMask = board->getMask('O');
+        PerfectPlay::Entry entry = PerfectPlay::lookup(xMask, oMask);
+        if (entry.reachable && entry.bestMoves != 0 &&
+            PerfectPlay::popcount(xMask) == PerfectPlay::popcount(oMask) + 1) {
+            for (int cell = 0; cell < 9; ++cell) {
+                if (entry.bestMoves & (1u << cell)) {
+                    return {cell / 3, cell % 3};
+                }
+            }
+        }
+    }
+
+    std::vector<RootMove> moves = analyzeRoot(board);
+    if (moves.empty()) {
+        return {-1, -1};
+    }
 
-    auto availableMoves = board->getAvailableMoves();
+    // An immediate win is what the search would pick; skip it
+    for (const RootMove& root : moves) {
+        if (root.wins) {
+            return root.move;
+        }
+    }
+
+    rankRootMoves(board, moves);
+    return moves.front().move;
+}
+
+AIPlayer::RootMove AIPlayer::analyzeMove(Board* board, int row, int col) const
+{
+    RootMove root;
+    root.move = {row, col};
+    if (board->makeMove(row, col, side)) {
+        root.wins = board->checkWin(side);
+        board->undoMove(row, col);
+    }
+    if (board->makeMove(row, col, opponent())) {
+        root.blocks = board->checkWin(opponent());
+        board->undoMove(row, col);
+    }
+    return root;
+}
 
-    if (availableMoves.empty()) {
-        return bestMove;
+std::vector<AIPlayer::RootMove> AIPlayer::analyzeRoot(Board* board) const
+{
+    // Every candidate stays in the list, so mistakes can still pick any of
+    // several equivalent cells, but symmetric copies share one analysis
+    MoveList candidates;
+    getCandidateMoves(*board, candidates);
+    int representatives[Board::MAX_CELLS];
+    board->findSymmetricMoves(candidates, representatives);
+
+    std::vector<RootMove> moves;
+    moves.reserve(candidates.size());
+    for (int i = 0; i < candidates.size(); ++i) {
+        const Move& move = candidates[i];
+        int representative = representatives[i];
+        if (representative == i) {
+            moves.push_back(analyzeMove(board, move.row, move.col));
+        } else {
+            moves.push_back(moves[representative]);
+            moves.back().move = {move.row, move.col};
+        }
+        moves.back().representative = representative;
     }
+    return moves;
+}
 
-    for (const auto& move : availableMoves) {
-        Board testBoard = *board;
+void AIPlayer::rankRootMoves(Board* board, std::vector<RootMove>& moves)
+{
+    // MCTS scores root moves by visit count, which orders them the same way.
+    // A fresh root only expands one move of each symmetric set, so a move it
+    // did not visit takes its representative's count. The analysed moves, and
+    // their win and block flags, are all kept.
+    if (engine == MCTS) {
+        auto visited = mctsEngine.search(*board, getPlayouts(), deadline, cancelRequested);
+        lastStats.nodes += mctsEngine.getLastPlayoutCount();
+        int size = board->getSize();
+        int visits[Board::MAX_CELLS];
+        std::fill(visits, visits + Board::MAX_CELLS, -1);
+        for (const auto& scored : visited) {
+            visits[scored.first.first * size + scored.first.second] = scored.second;
+        }
+        for (RootMove& root : moves) {
+            int cell = root.move.first * size + root.move.second;
+            if (visits[cell] < 0) {
+                const RootMove& representative = moves[root.representative];
+                cell = representative.move.first * size + representative.move.second;
+            }
+            root.score = std::max(visits[cell], 0);
+        }
+    } else {
+        // Only the first of each set of symmetric moves is searched
+        MoveList rootMoves;
+        int searched[Board::MAX_CELLS];
+        for (int i = 0; i < static_cast<int>(moves.size()); ++i) {
+            if (moves[i].representative == i) {
+                searched[i] = rootMoves.size();
+                rootMoves.push(moves[i].move.first, moves[i].move.second);
+            }
+        }
+        std::vector<int> scores(rootMoves.size());
+
+        // Iterative deepening: each finished depth replaces the previous
+        // scores, and a depth cut short by the time limit is thrown away.
+        // Out of time before the first depth finished, every move keeps 0.
+        int maxDepth = getMaxDepth(*board);
+        for (int depthLimit = 1; depthLimit <= maxDepth; ++depthLimit) {
+            long long horizonHits = 0;
+            if (!searchRootMoves(board, rootMoves, depthLimit, scores, horizonHits)) {
+                break;
+            }
 
-        if (testBoard.makeMove(move.first, move.second, 'O')) {
-            int score = minimax(testBoard, 0, false, INT_MIN, INT_MAX);
+            for (RootMove& root : moves) {
+                root.score = scores[searched[root.representative]];
+            }
+            lastStats.completedDepth = depthLimit;
 
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = move;
+            // Every line already reached the end of the game; deeper is identical
+            if (horizonHits == 0) {
+                break;
             }
         }
     }
 
-    return bestMove;
+    // Best first; equal scores keep generation order
+    std::stable_sort(moves.begin(), moves.end(),
+                     [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+}
+
+// Scores every root move at one depth. Returns false if the search was
+// stopped by the time limit or a cancel before every move was scored.
+bool AIPlayer::searchRootMoves(Board* board, const MoveList& moves, int depthLimit,
+                               std::vector<int>& scores, long long& horizonHits)
+{
+    if (threadPool.size() == 1) {
+        SearchContext context;
+        context.searchDepth = depthLimit;
+        context.ordering = &orderingTables[0];
+        bool stopped = false;
+        for (int i = 0; i < moves.size() && !stopped; ++i) {
+            board->makeMove(moves[i].row, moves[i].col, side);
+            scores[i] = minimax(context, *board, 0, false, INT_MIN, INT_MAX);
+            board->undoMove(moves[i].row, moves[i].col);
+            stopped = shouldStop(context);
+        }
+        recordStats(context);
+        horizonHits = context.horizonHits;
+        return !stopped;
+    }
+
+    ParallelMode mode = parallelMode;
+    std::atomic<int> nextMove(0);
+    std::atomic<bool> stopped(false);
+    std::atomic<bool> mainDone(false);
+    std::vector<SearchContext> contexts(threadPool.size());
+
+    threadPool.run([&](int worker) {
+        Board local = *board;
+        SearchContext& context = contexts[worker];
+        context.searchDepth = depthLimit;
+        context.ordering = &orderingTables[worker];
+
+        if (mode == LAZY_SMP && worker > 0) {
+            // Helpers only fill the shared table: odd ones search a ply deeper
+            // and each starts at a different root move so they diverge
+            context.searchDepth = depthLimit + (worker & 1);
+            context.abort = &mainDone;
+            for (int n = 0; n < moves.size() && !shouldStop(context); ++n) {
+                const Move& move = moves[(n + worker) % moves.size()];
+                local.makeMove(move.row, move.col, side);
+                minimax(context, local, 0, false, INT_MIN, INT_MAX);
+                local.undoMove(move.row, move.col);
+            }
+            return;
+        }
+
+        // Lazy SMP: worker 0 scores every move. Root split: take the next move.
+        for (int n = 0; n < moves.size(); ++n) {
+            int i = mode == LAZY_SMP ? n : nextMove++;
+            if (i >= moves.size()) {
+                break;
+            }
+            local.makeMove(moves[i].row, moves[i].col, side);
+            scores[i] = minimax(context, local, 0, false, INT_MIN, INT_MAX);
+            local.undoMove(moves[i].row, moves[i].col);
+            if (shouldStop(context)) {
+                stopped = true;
+                break;
+            }
+        }
+        mainDone = true;
+    });
+
+    // Helper threads' horizon hits say nothing about worker 0's scores
+    horizonHits = 0;
+    for (int worker = 0; worker < static_cast<int>(contexts.size()); ++worker) {
+        recordStats(contexts[worker]);
+        if (mode == ROOT_SPLIT || worker == 0) {
+            horizonHits += contexts[worker].horizonHits;
+        }
+    }
+    return !stopped;
 }
 
 std::pair<int, int> AIPlayer::getRandomMove(Board* board)
 {
-    auto availableMoves = board->getAvailableMoves();
+    MoveList availableMoves;
+    board->generateMoves(availableMoves);
     if (!availableMoves.empty()) {
-        std::uniform_int_distribution<> dist(0, availableMoves.size() - 1);
-        return availableMoves[dist(rng)];
+        const Move& move = availableMoves[rng.below(availableMoves.size())];
+        return {move.row, move.col};
     }
     return {-1, -1};
 }
 
-int AIPlayer::minimax(Board board, int depth, bool isMaximizing, int alpha, int beta)
+void AIPlayer::recordStats(const SearchContext& context)
 {
-    int boardScore = evaluateBoard(board);
+    lastStats.nodes += context.nodes;
+    lastStats.cutoffs += context.cutoffs;
+    lastStats.firstMoveCutoffs += context.firstMoveCutoffs;
+    lastStats.tableProbes += context.tableProbes;
+    lastStats.tableHits += context.tableHits;
+    lastStats.maxPly = std::max(lastStats.maxPly, context.maxPly);
+    expandedNodes += context.expanded;
+    searchedChildren += context.children;
+}
 
-    if (boardScore == 10 || boardScore == -10 || board.checkTie()) {
-        return boardScore - depth;
+bool AIPlayer::shouldStop(SearchContext& context) const
+{
+    // Reading the clock is comparatively slow, so only look every 1024 nodes
+    if (!context.timeUp && (context.nodes & 1023) == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+        context.timeUp = true;
     }
+    return context.timeUp || cancelRequested.load(std::memory_order_relaxed) ||
+           (context.abort && context.abort->load(std::memory_order_relaxed));
+}
+
+int AIPlayer::getPlayouts() const
+{
+    switch (difficulty) {
+    case EASY:
+        return std::max(1, playoutBudget / 16);
+    case MEDIUM:
+        return std::max(1, playoutBudget / 4);
+    case HARD:
+    default:
+        return playoutBudget;
+    }
+}
 
+int AIPlayer::getMaxDepth(const Board& board) const
+{
     // Adjust depth based on difficulty
-    int maxDepth;
+    if (board.isClassic()) {
+        switch (difficulty) {
+        case EASY:
+            return 4;
+        case MEDIUM:
+            return 5;
+        case HARD:
+        default:
+            return 9;
+        }
+    }
+
+    // Larger boards: EASY and MEDIUM stay shallow on purpose, HARD deepens
+    // until the game is resolved or the time limit runs out
+    int size = board.getSize();
+    int bonus = size <= 4 ? 2 : (size <= 6 ? 0 : -1);
     switch (difficulty) {
     case EASY:
-        maxDepth = 4;
-        break;
+        return std::max(1, 1 + bonus);
     case MEDIUM:
-        maxDepth = 5;
-        break;
+        return std::max(1, 2 + bonus);
     case HARD:
     default:
-        maxDepth = 9;
-        break;
+        return size * size - board.getMoveCount();
+    }
+}
+
+int AIPlayer::minimax(SearchContext& context, Board& board, int depth, bool isMaximizing,
+                      int alpha, int beta)
+{
+    ++context.nodes;
+    // The root move itself is ply 1
+    context.maxPly = std::max(context.maxPly, depth + 1);
+
+    if (shouldStop(context)) {
+        return 0;
     }
 
+    int boardScore = evaluateBoard(board);
+
+    if (boardScore == WIN_SCORE || boardScore == -WIN_SCORE || board.checkTie()) {
+        return boardScore - depth;
+    }
+
+    int maxDepth = context.searchDepth;
+
+    // Horizon nodes take the static estimate at this ply, so every score below
+    // is (ply-independent value) - depth and can be shared between searches.
     if (depth >= maxDepth) {
-        return boardScore;
+        ++context.horizonHits;
+        return evaluatePosition(board) - depth;
+    }
+
+    // Entries are stored with the ply offset removed and are only reused when
+    // they were searched to the same remaining depth or to the end of the game.
+    // Rotations and reflections of a position share one entry.
+    int draft = maxDepth - depth;
+    uint64_t key = board.getCanonicalHash() ^ (isMaximizing ? Zobrist::SIDE_TO_MOVE : 0);
+    TranspositionTable::Entry entry;
+    ++context.tableProbes;
+    if (transpositionTable.probe(key, entry) &&
+        (entry.draft == draft || entry.draft == TranspositionTable::FULL_DRAFT)) {
+        ++context.tableHits;
+        int stored = entry.score - depth;
+        if (entry.draft != TranspositionTable::FULL_DRAFT) {
+            ++context.horizonHits;
+        }
+        if (entry.bound == TranspositionTable::EXACT) {
+            return stored;
+        }
+        if (entry.bound == TranspositionTable::LOWER) {
+            alpha = std::max(alpha, stored);
+        } else {
+            beta = std::min(beta, stored);
+        }
+        if (beta <= alpha) {
+            return stored;
+        }
     }
 
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    long long horizonBefore = context.horizonHits;
+    int bestEval;
+    ++context.expanded;
+
     if (isMaximizing) {
         int maxEval = INT_MIN;
-        auto moves = board.getAvailableMoves();
+        MoveList moves;
+        getCandidateMoves(board, moves);
+        orderMoves(context, board, moves, depth, draft, side);
 
         for (const auto& move : moves) {
-            Board newBoard = board;
-            if (newBoard.makeMove(move.first, move.second, 'O')) {
-                int eval = minimax(newBoard, depth + 1, false, alpha, beta);
+            if (board.makeMove(move.row, move.col, side)) {
+                int eval = minimax(context, board, depth + 1, false, alpha, beta);
+                board.undoMove(move.row, move.col);
+                ++context.children;
                 maxEval = std::max(maxEval, eval);
                 alpha = std::max(alpha, eval);
 
                 if (beta <= alpha) {
+                    ++context.cutoffs;
+                    if (&move == moves.begin()) {
+                        ++context.firstMoveCutoffs;
+                    }
+                    recordCutoff(context, board.getSize(), move, depth, draft, side);
                     break;
                 }
             }
         }
-        return maxEval;
+        bestEval = maxEval;
     } else {
         int minEval = INT_MAX;
-        auto moves = board.getAvailableMoves();
+        MoveList moves;
+        getCandidateMoves(board, moves);
+        orderMoves(context, board, moves, depth, draft, opponent());
 
         for (const auto& move : moves) {
-            Board newBoard = board;
-            if (newBoard.makeMove(move.first, move.second, 'X')) {
-                int eval = minimax(newBoard, depth + 1, true, alpha, beta);
+            if (board.makeMove(move.row, move.col, opponent())) {
+                int eval = minimax(context, board, depth + 1, true, alpha, beta);
+                board.undoMove(move.row, move.col);
+                ++context.children;
                 minEval = std::min(minEval, eval);
                 beta = std::min(beta, eval);
 
                 if (beta <= alpha) {
+                    ++context.cutoffs;
+                    if (&move == moves.begin()) {
+                        ++context.firstMoveCutoffs;
+                    }
+                    recordCutoff(context, board.getSize(), move, depth, draft, opponent());
                     break;
                 }
             }
         }
-        return minEval;
+        bestEval = minEval;
+    }
+
+    if (shouldStop(context)) {
+        return bestEval;
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+    if (bestEval <= alphaOrig) {
+        bound = TranspositionTable::UPPER;
+    } else if (bestEval >= betaOrig) {
+        bound = TranspositionTable::LOWER;
+    }
+    bool resolved = context.horizonHits == horizonBefore;
+    transpositionTable.store(key, bestEval + depth,
+                             resolved ? TranspositionTable::FULL_DRAFT : draft, bound);
+
+    return bestEval;
+}
+
+void AIPlayer::OrderingTables::clear()
+{
+    for (auto& pair : killers) {
+        pair[0] = pair[1] = Move{-1, -1};
+    }
+    for (auto& side : history) {
+        std::fill(std::begin(side), std::end(side), 0);
+    }
+}
+
+void AIPlayer::computeCellPriors(const Board& board)
+{
+    // Every window of winLength cells in any direction that covers the cell:
+    // the centre of 3x3 lies on 4 lines, a corner on 3 and an edge on 2
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int size = board.getSize();
+    int winLength = board.getWinLength();
+    cellPriors.fill(0);
+
+    for (const auto& dir : directions) {
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                int endRow = row + dir[0] * (winLength - 1);
+                int endCol = col + dir[1] * (winLength - 1);
+                if (endRow < 0 || endRow >= size || endCol < 0 || endCol >= size) {
+                    continue;
+                }
+                for (int step = 0; step < winLength; ++step) {
+                    ++cellPriors[(row + dir[0] * step) * size + col + dir[1] * step];
+                }
+            }
+        }
+    }
+}
+
+void AIPlayer::orderMoves(const SearchContext& context, const Board& board, MoveList& moves,
+                          int depth, int draft, char mover) const
+{
+    if (!moveOrdering || !context.ordering || moves.size() < 2) {
+        return;
+    }
+
+    const OrderingTables& tables = *context.ordering;
+    const Move* killers = tables.killers[depth];
+    const int* history = tables.history[mover == 'X' ? 0 : 1];
+    char other = mover == 'X' ? 'O' : 'X';
+    int size = board.getSize();
+
+    // On 3x3 a line test is one lookup over the 9-bit masks. Elsewhere it
+    // walks the lines, so one ply from the horizon, where a block changes
+    // nothing the search can see and a win shows up at its leaf, it is skipped.
+    bool classic = board.isClassic();
+    bool tactics = classic || draft > 1;
+    uint16_t moverMask = board.getMask(mover);
+    uint16_t otherMask = board.getMask(other);
+
+    int keys[Board::MAX_CELLS];
+    for (int i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+        int cell = move.row * size + move.col;
+        if (tactics && (classic ? Board::isWinningMask(moverMask | (1u << cell))
+                                : board.completesLine(move.row, move.col, mover))) {
+            keys[i] = WIN_KEY;
+        } else if (tactics && (classic ? Board::isWinningMask(otherMask | (1u << cell))
+                                       : board.completesLine(move.row, move.col, other))) {
+            keys[i] = BLOCK_KEY;
+        } else if (move.row == killers[0].row && move.col == killers[0].col) {
+            keys[i] = KILLER_KEY + 1;
+        } else if (move.row == killers[1].row && move.col == killers[1].col) {
+            keys[i] = KILLER_KEY;
+        } else {
+            keys[i] = history[cell] * 128 + cellPriors[cell];
+        }
     }
+
+    // Insertion sort: lists are short and equal keys keep generation order
+    for (int i = 1; i < moves.size(); ++i) {
+        Move move = moves[i];
+        int key = keys[i];
+        int j = i;
+        for (; j > 0 && keys[j - 1] < key; --j) {
+            moves[j] = moves[j - 1];
+            keys[j] = keys[j - 1];
+        }
+        moves[j] = move;
+        keys[j] = key;
+    }
+}
+
+void AIPlayer::recordCutoff(SearchContext& context, int size, const Move& move, int depth,
+                            int draft, char mover)
+{
+    if (!context.ordering) {
+        return;
+    }
+
+    Move* killers = context.ordering->killers[depth];
+    if (killers[0].row != move.row || killers[0].col != move.col) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+
+    // Cutoffs with more depth below them count for more
+    int& score = context.ordering->history[mover == 'X' ? 0 : 1][move.row * size + move.col];
+    score = std::min(score + draft * draft, HISTORY_LIMIT);
 }
 
 int AIPlayer::evaluateBoard(const Board& board)
 {
-    if (board.checkWin('O')) {
-        return 10;
+    if (board.checkWin(side)) {
+        return WIN_SCORE;
     }
-    if (board.checkWin('X')) {
-        return -10;
+    if (board.checkWin(opponent())) {
+        return -WIN_SCORE;
     }
     if (board.checkTie()) {
         return 0;
@@ -241,3 +710,60 @@ int AIPlayer::evaluateBoard(const Board& board)
 
     return 0;
 }
+
+int AIPlayer::evaluatePosition(const Board& board) const
+{
+    // The classic board is small enough to search without an estimate
+    if (board.isClassic()) {
+        return 0;
+    }
+
+    // Every window of winLength cells still open to one side scores for that
+    // side, weighted 4x per stone already in it
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int size = board.getSize();
+    int winLength = board.getWinLength();
+    int score = 0;
+
+    for (const auto& dir : directions) {
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                int endRow = row + dir[0] * (winLength - 1);
+                int endCol = col + dir[1] * (winLength - 1);
+                if (endRow < 0 || endRow >= size || endCol < 0 || endCol >= size) {
+                    continue;
+                }
+
+                int xCount = 0;
+                int oCount = 0;
+                for (int step = 0; step < winLength; ++step) {
+                    char cell = board.getCell(row + dir[0] * step, col + dir[1] * step);
+                    if (cell == 'X') {
+                        ++xCount;
+                    } else if (cell == 'O') {
+                        ++oCount;
+                    }
+                }
+
+                if (oCount > 0 && xCount == 0) {
+                    score += 1 << (2 * (oCount - 1));
+                } else if (xCount > 0 && oCount == 0) {
+                    score -= 1 << (2 * (xCount - 1));
+                }
+            }
+        }
+    }
+
+    // Scores above favour O
+    if (side == 'X') {
+        score = -score;
+    }
+
+    // Stay well clear of any won score
+    return std::clamp(score, -WIN_SCORE / 2, WIN_SCORE / 2);
+}
+
+void AIPlayer::getCandidateMoves(const Board& board, MoveList& moves) const
+{
+    board.generateCandidateMoves(moves);
+}
@@ -5,8 +5,15 @@
 #include <vector>
 #include <climits>
 #include <algorithm>
-#include <random>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include "Board.h"
+#include "TranspositionTable.h"
+#include "ThreadPool.h"
+#include "MctsEngine.h"
+#include "Random.h"
 
 class AIPlayer
 {
@@ -17,21 +24,171 @@ public:
         HARD
     };
 
-    AIPlayer(Difficulty diff = HARD);
+    enum ParallelMode {
+        ROOT_SPLIT,   // threads take root moves from a shared queue
+        LAZY_SMP      // helpers search the whole root to warm the shared table
+    };
+
+    enum Engine {
+        MINIMAX,      // alpha-beta to a depth set by the difficulty
+        MCTS          // Monte Carlo tree search with a playout budget
+    };
+
+    // What the search behind one getMove call did
+    struct SearchStats {
+        long long nodes = 0;            // minimax nodes, or MCTS playouts
+        long long cutoffs = 0;          // alpha-beta cutoffs
+        long long firstMoveCutoffs = 0; // cutoffs made by the first move tried
+        long long tableProbes = 0;
+        long long tableHits = 0;        // probes whose entry could be used
+        int completedDepth = 0;         // deepest iteration that finished
+        int maxPly = 0;                 // deepest ply any line reached
+        double branchingFactor = 0.0;   // moves searched per expanded node
+        double wallTimeMs = 0.0;
+    };
+
+    AIPlayer(Difficulty diff = HARD, uint64_t seed = Random::randomSeed());
     ~AIPlayer() = default;
 
     std::pair<int, int> getMove(Board* board);
     void setDifficulty(Difficulty diff) { difficulty = diff; }
+    Difficulty getDifficulty() const { return difficulty; }
+
+    // Mark the AI plays, 'O' by default. Change it only between moves.
+    void setSide(char mark) { side = mark == 'X' ? 'X' : 'O'; }
+    char getSide() const { return side; }
+
+    // Reseeds every random choice (EASY/MEDIUM mistakes, MCTS playouts), so
+    // games without a time limit can be replayed move for move. getSeed()
+    // returns the last seed, to be quoted in bug reports.
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const { return rng.getSeed(); }
+
+    // Thread-safe: makes a running getMove unwind and return {-1, -1}.
+    // The flag stays set until clearCancel() is called.
+    void cancel() { cancelRequested = true; }
+    void clearCancel() { cancelRequested = false; }
+    bool isCancelled() const { return cancelRequested; }
+
+    // Per-move search budget in milliseconds (0 = no limit). Searches deepen
+    // one ply at a time and play the result of the last depth that finished.
+    void setTimeLimit(int milliseconds) { timeLimitMs = milliseconds; }
+    int getTimeLimit() const { return timeLimitMs; }
+
+    // Search threads, including the calling one (1 = serial search)
+    void setThreadCount(int threads) { threadCount = std::max(1, threads); }
+    int getThreadCount() const { return threadCount; }
+    void setParallelMode(ParallelMode mode) { parallelMode = mode; }
+    ParallelMode getParallelMode() const { return parallelMode; }
+
+    // Search used behind the difficulty levels. With MCTS, HARD runs the full
+    // playout budget, MEDIUM a quarter and EASY a sixteenth, all still
+    // bounded by the time limit. MCTS searches on the calling thread only.
+    void setEngine(Engine engine) { this->engine = engine; }
+    Engine getEngine() const { return engine; }
+    void setPlayoutBudget(int playouts) { playoutBudget = std::max(1, playouts); }
+    int getPlayoutBudget() const { return playoutBudget; }
+
+    // Tries wins, blocks, killer moves and moves with a history of cutoffs
+    // first, then cells on the most winning lines. On by default; switching
+    // it off only shows what it saves.
+    void setMoveOrdering(bool enabled) { moveOrdering = enabled; }
+    bool getMoveOrdering() const { return moveOrdering; }
+
+    // Score of a won position before the ply adjustment
+    static constexpr int WIN_SCORE = 1000;
+
+    // Statistics of the last getMove call; read them after it returns
+    SearchStats getLastSearchStats() const { return lastStats; }
+    long long getLastNodeCount() const { return lastStats.nodes; }
+    int getLastCompletedDepth() const { return lastStats.completedDepth; }
+    void clearTranspositionTable() { transpositionTable.clear(); }
 
 private:
-    Difficulty difficulty;
-    std::mt19937 rng;
-    int minimax(Board board, int depth, bool isMaximizing, int alpha, int beta);
+    std::atomic<Difficulty> difficulty;
+    std::atomic<bool> cancelRequested;
+    std::atomic<int> timeLimitMs;
+    std::atomic<int> threadCount;
+    std::atomic<ParallelMode> parallelMode;
+    std::atomic<Engine> engine;
+    std::atomic<int> playoutBudget;
+    std::atomic<bool> moveOrdering;
+    Random rng;
+    char side;
+    TranspositionTable transpositionTable;
+    ThreadPool threadPool;
+    MctsEngine mctsEngine;
+    SearchStats lastStats;
+    long long expandedNodes;
+    long long searchedChildren;
+    int tableSize;
+    int tableWinLength;
+    std::chrono::steady_clock::time_point deadline;
+
+    // What one search thread learns from its cutoffs: two killer moves per
+    // ply and a history score per side and cell. Cleared every getMove.
+    struct OrderingTables {
+        Move killers[Board::MAX_CELLS][2];
+        int history[2][Board::MAX_CELLS];
+        void clear();
+    };
+
+    std::vector<OrderingTables> orderingTables;
+    std::array<int, Board::MAX_CELLS> cellPriors;   // winning lines through each cell
+
+    // One root move as seen by a turn's analysis
+    struct RootMove {
+        std::pair<int, int> move;
+        int score = 0;          // search score or MCTS visits, once ranked
+        bool wins = false;      // completes a line for the AI
+        bool blocks = false;    // takes a cell that completes one for the opponent
+        int representative = 0; // earlier move it is symmetric to, or its own index;
+                                // only meaningful until the list is ranked
+    };
+
+    // State owned by one search thread
+    struct SearchContext {
+        int searchDepth = 0;
+        long long nodes = 0;
+        long long horizonHits = 0;
+        long long cutoffs = 0;
+        long long firstMoveCutoffs = 0;
+        long long tableProbes = 0;
+        long long tableHits = 0;
+        long long expanded = 0;
+        long long children = 0;
+        int maxPly = 0;
+        bool timeUp = false;
+        const std::atomic<bool>* abort = nullptr;
+        OrderingTables* ordering = nullptr;
+    };
+
+    char opponent() const { return side == 'X' ? 'O' : 'X'; }
+    int getMaxDepth(const Board& board) const;
+    int getPlayouts() const;
+    bool shouldStop(SearchContext& context) const;
+    void recordStats(const SearchContext& context);
+    bool searchRootMoves(Board* board, const MoveList& moves, int depthLimit,
+                         std::vector<int>& scores, long long& horizonHits);
+    RootMove analyzeMove(Board* board, int row, int col) const;
+    // Every root move with its win/block flags, before any search
+    std::vector<RootMove> analyzeRoot(Board* board) const;
+    // Searches the analysed moves once and sorts them best first
+    void rankRootMoves(Board* board, std::vector<RootMove>& moves);
+    std::pair<int, int> chooseMove(Board* board);
+    int minimax(SearchContext& context, Board& board, int depth, bool isMaximizing, int alpha, int beta);
+    void orderMoves(const SearchContext& context, const Board& board, MoveList& moves, int depth,
+                    int draft, char mover) const;
+    static void recordCutoff(SearchContext& context, int size, const Move& move, int depth,
+                             int draft, char mover);
+    void computeCellPriors(const Board& board);
     int evaluateBoard(const Board& board);
+    int evaluatePosition(const Board& board) const;
+    void getCandidateMoves(const Board& board, MoveList& moves) const;
     std::pair<int, int> getBestMove(Board* board);
     std::pair<int, int> getRandomMove(Board* board);
     std::pair<int, int> getMediumMove(Board* board);
-    std::pair<int, int> getSuboptimalMove(Board* board);
+    std::pair<int, int> getSuboptimalMove(Board* board, const std::vector<RootMove>& ranked);
     bool shouldMakeMistake();
     bool shouldMissBlock();
     bool shouldMakeRandomMistake();
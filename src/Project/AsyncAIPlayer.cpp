@@ -0,0 +1,51 @@
+#include "AsyncAIPlayer.h"
+#include <QMetaObject>
+
+AsyncAIPlayer::AsyncAIPlayer(AIPlayer* player, QObject* parent)
+    : QObject(parent), aiPlayer(player), generation(0), searching(false)
+{
+    // One worker keeps searches serialized on the shared AIPlayer state
+    workerPool.setMaxThreadCount(1);
+}
+
+AsyncAIPlayer::~AsyncAIPlayer()
+{
+    cancel();
+    workerPool.waitForDone();
+}
+
+void AsyncAIPlayer::requestMove(const Board& board)
+{
+    quint64 id = ++generation;
+    searching = true;
+
+    workerPool.start([this, board, id]() mutable {
+        // Clear before checking the generation so a cancel() that lands in
+        // between is seen either here or by the search itself
+        aiPlayer->clearCancel();
+        if (id != generation) {
+            return;
+        }
+
+        auto move = aiPlayer->getMove(&board);
+        AIPlayer::SearchStats stats = aiPlayer->getLastSearchStats();
+
+        QMetaObject::invokeMethod(this, [this, move, stats, id]() {
+            if (id != generation) {
+                return;
+            }
+            searching = false;
+            if (move.first >= 0 && move.second >= 0) {
+                emit searchFinished(stats);
+                emit moveReady(move.first, move.second);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AsyncAIPlayer::cancel()
+{
+    ++generation;
+    searching = false;
+    aiPlayer->cancel();
+}
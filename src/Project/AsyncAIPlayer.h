@@ -0,0 +1,37 @@
+#ifndef ASYNCAIPLAYER_H
+#define ASYNCAIPLAYER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include "Board.h"
+#include "AIPlayer.h"
+
+// Runs AIPlayer::getMove on a worker thread and reports the result through
+// moveReady. Searches run one at a time; cancel() aborts the running search
+// and drops any result that has not been delivered yet.
+class AsyncAIPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncAIPlayer(AIPlayer* player, QObject* parent = nullptr);
+    ~AsyncAIPlayer();
+
+    void requestMove(const Board& board);
+    void cancel();
+    bool isSearching() const { return searching; }
+
+signals:
+    // Emitted just before moveReady, with the stats of the search behind it
+    void searchFinished(const AIPlayer::SearchStats& stats);
+    void moveReady(int row, int col);
+
+private:
+    AIPlayer* aiPlayer;
+    QThreadPool workerPool;
+    std::atomic<quint64> generation;
+    bool searching;
+};
+
+#endif // ASYNCAIPLAYER_H
@@ -0,0 +1,58 @@
+#include "BackgroundCache.h"
+#include <QHash>
+#include <QPixmapCache>
+
+namespace {
+// A 4K RGB32 pixmap is about 32 MB, well over QPixmapCache's default limit
+constexpr int CACHE_LIMIT_KB = 256 * 1024;
+
+QString scaledKey(const QString& name, const QSize& size)
+{
+    return QString("background:%1:%2x%3").arg(name).arg(size.width()).arg(size.height());
+}
+
+const QPixmap& source(const QString& name)
+{
+    // Decoded images are few and small next to their scaled copies, so they
+    // are kept for the whole run rather than competing in QPixmapCache
+    static QHash<QString, QPixmap> sources;
+    auto it = sources.find(name);
+    if (it == sources.end()) {
+        it = sources.insert(name, QPixmap(":/images/" + name));
+    }
+    return it.value();
+}
+}
+
+namespace BackgroundCache
+{
+QPixmap scaled(const QString& name, const QSize& size)
+{
+    QPixmap pixmap = cached(name, size);
+    if (!pixmap.isNull() || source(name).isNull() || size.isEmpty()) {
+        return pixmap;
+    }
+
+    if (QPixmapCache::cacheLimit() < CACHE_LIMIT_KB) {
+        QPixmapCache::setCacheLimit(CACHE_LIMIT_KB);
+    }
+    pixmap = source(name).scaled(size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    QPixmapCache::insert(scaledKey(name, size), pixmap);
+    return pixmap;
+}
+
+QPixmap cached(const QString& name, const QSize& size)
+{
+    QPixmap pixmap;
+    QPixmapCache::find(scaledKey(name, size), &pixmap);
+    return pixmap;
+}
+
+QPixmap preview(const QString& name, const QSize& size)
+{
+    if (source(name).isNull() || size.isEmpty()) {
+        return QPixmap();
+    }
+    return source(name).scaled(size, Qt::KeepAspectRatioByExpanding, Qt::FastTransformation);
+}
+}
@@ -0,0 +1,21 @@
+#ifndef BACKGROUNDCACHE_H
+#define BACKGROUNDCACHE_H
+
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+// Background images, decoded once and kept scaled per target size, so
+// resizing and reopening dialogs does not go back to the JPEG. Images come
+// from the :/images resource bundle. GUI thread only, like QPixmapCache.
+namespace BackgroundCache
+{
+// `name` smooth-scaled to cover `size`; null if the image is missing
+QPixmap scaled(const QString& name, const QSize& size);
+// Only what is already cached, without scaling anything
+QPixmap cached(const QString& name, const QSize& size);
+// A quick nearest-neighbour scale for frames in the middle of a resize
+QPixmap preview(const QString& name, const QSize& size);
+}
+
+#endif // BACKGROUNDCACHE_H
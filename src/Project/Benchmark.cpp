@@ -0,0 +1,265 @@
+// Microbenchmarks for the engine hot paths. Each case repeats until it has
+// run for --min-time seconds and reports time per call, search nodes per
+// call and per second, and heap allocations per call.
+//
+//   TicTacToeBenchmark [--filter=substring] [--min-time=seconds]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "AIPlayer.h"
+
+namespace {
+std::atomic<long long> allocationCount(0);
+}
+
+// Count every heap allocation made by the process
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+struct Options {
+    std::string filter;
+    double minTime = 0.2;
+};
+
+struct Position {
+    const char* name;
+    Board board;
+};
+
+volatile long long sink;
+
+// Blocks the compiler from dropping a result it can prove unused
+template <typename T>
+void keep(const T& value)
+{
+    sink = static_cast<long long>(value);
+}
+
+// body() runs the operation once and returns the search nodes it visited.
+// reset(), if given, runs before every call and is left out of the time,
+// the node count and the allocation count.
+void runBenchmark(const Options& options, const std::string& name,
+                  const std::function<long long()>& body,
+                  const std::function<void()>& reset = nullptr)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    long long iterations = 0;
+    long long nodes = 0;
+    long long allocationsBefore = allocationCount;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+
+    if (reset) {
+        // Time each call on its own. A reset can cost far more than a fast
+        // call, so also stop once the whole loop has run 20x minTime.
+        double wall = 0.0;
+        while (elapsed < options.minTime && wall < 20 * options.minTime) {
+            long long allocationsBeforeReset = allocationCount;
+            reset();
+            allocationsBefore += allocationCount - allocationsBeforeReset;
+
+            auto callStart = Clock::now();
+            nodes += body();
+            auto callEnd = Clock::now();
+            elapsed += std::chrono::duration<double>(callEnd - callStart).count();
+            wall = std::chrono::duration<double>(callEnd - start).count();
+            ++iterations;
+        }
+    } else {
+        // Grow the batch so the clock is read rarely on fast operations
+        for (long long batch = 1; elapsed < options.minTime; batch *= 2) {
+            for (long long i = 0; i < batch; ++i) {
+                nodes += body();
+            }
+            iterations += batch;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    }
+
+    double nsPerOp = elapsed * 1e9 / iterations;
+    double allocationsPerOp = double(allocationCount - allocationsBefore) / iterations;
+    if (nodes > 0) {
+        std::printf("%-48s %12lld %14.1f %12.0f %14.0f %10.2f\n", name.c_str(), iterations, nsPerOp,
+                    double(nodes) / iterations, nodes / elapsed, allocationsPerOp);
+    } else {
+        std::printf("%-48s %12lld %14.1f %12s %14s %10.2f\n", name.c_str(), iterations, nsPerOp, "-",
+                    "-", allocationsPerOp);
+    }
+}
+
+// Plays seeded random moves until `fill` of the board is covered, skipping
+// any move that would end the game, so the position is still open
+Board makePosition(int size, int winLength, double fill, unsigned seed)
+{
+    Board board(size, winLength);
+    std::mt19937 rng(seed);
+    int target = static_cast<int>(size * size * fill);
+    char player = 'X';
+
+    while (board.getMoveCount() < target) {
+        auto moves = board.getAvailableMoves();
+        bool placed = false;
+        for (int attempt = 0; attempt < 32 && !placed; ++attempt) {
+            auto move = moves[rng() % moves.size()];
+            board.makeMove(move.first, move.second, player);
+            if (board.checkWin(player) || board.checkTie()) {
+                board.undoMove(move.first, move.second);
+            } else {
+                placed = true;
+            }
+        }
+        if (!placed) {
+            break;
+        }
+        player = player == 'X' ? 'O' : 'X';
+    }
+    return board;
+}
+
+// AIPlayer plays O by default, so positions handed to getMove need X to move last
+Board withOToMove(Board board)
+{
+    if (board.getMoveCount() % 2 == 1) {
+        return board;
+    }
+    auto moves = board.getAvailableMoves();
+    for (const auto& move : moves) {
+        board.makeMove(move.first, move.second, 'X');
+        if (!board.checkWin('X') && !board.checkTie()) {
+            return board;
+        }
+        board.undoMove(move.first, move.second);
+    }
+    return board;
+}
+
+const char* difficultyName(AIPlayer::Difficulty difficulty)
+{
+    switch (difficulty) {
+    case AIPlayer::EASY:
+        return "EASY";
+    case AIPlayer::MEDIUM:
+        return "MEDIUM";
+    case AIPlayer::HARD:
+    default:
+        return "HARD";
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+            options.filter = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+            options.minTime = std::atof(argv[i] + 11);
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter=substring] [--min-time=seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("%-48s %12s %14s %12s %14s %10s\n", "benchmark", "iterations", "ns/op", "nodes/op",
+                "nodes/s", "allocs/op");
+
+    const int variants[][2] = {{3, 3}, {4, 4}, {5, 4}, {15, 5}};
+    for (const auto& variant : variants) {
+        int size = variant[0];
+        int winLength = variant[1];
+        std::vector<Position> positions = {
+            {"empty", Board(size, winLength)},
+            {"midgame", makePosition(size, winLength, 0.4, 1)},
+            {"endgame", makePosition(size, winLength, 0.8, 2)},
+        };
+
+        for (const Position& position : positions) {
+            std::string suffix = "/" + std::to_string(size) + "x" + std::to_string(size) + "k" +
+                                 std::to_string(winLength) + "/" + position.name;
+            Board board = position.board;
+
+            runBenchmark(options, "Board::checkWin" + suffix, [&]() {
+                keep(board.checkWin('X'));
+                return 0LL;
+            });
+
+            // One pass over every empty cell; nodes/s counts moves
+            runBenchmark(options, "Board::makeMove+undoMove" + suffix, [&]() {
+                MoveList moves;
+                board.generateMoves(moves);
+                for (const Move& move : moves) {
+                    board.makeMove(move.row, move.col, 'O');
+                    board.undoMove(move.row, move.col);
+                }
+                return static_cast<long long>(moves.size());
+            });
+
+            runBenchmark(options, "Board::getAvailableMoves" + suffix, [&]() {
+                keep(board.getAvailableMoves().size());
+                return 0LL;
+            });
+
+            runBenchmark(options, "Board::generateCandidateMoves" + suffix, [&]() {
+                MoveList moves;
+                board.generateCandidateMoves(moves);
+                keep(moves.size());
+                return 0LL;
+            });
+
+            // Each search starts from an empty table, cleared outside the
+            // timed region, and is capped at 250 ms. A fixed seed makes the
+            // EASY/MEDIUM choices the same on every run.
+            Board searchBoard = withOToMove(position.board);
+            for (auto difficulty : {AIPlayer::EASY, AIPlayer::MEDIUM, AIPlayer::HARD}) {
+                AIPlayer ai(difficulty, 1);
+                ai.setTimeLimit(250);
+                runBenchmark(options, std::string("AIPlayer::getMove/") + difficultyName(difficulty) +
+                                          suffix, [&]() {
+                    keep(ai.getMove(&searchBoard).first);
+                    return ai.getLastNodeCount();
+                }, [&]() { ai.clearTranspositionTable(); });
+            }
+
+            // The same HARD search in generation order, to compare nodes/op
+            AIPlayer unordered(AIPlayer::HARD, 1);
+            unordered.setTimeLimit(250);
+            unordered.setMoveOrdering(false);
+            runBenchmark(options, "AIPlayer::getMove/HARD-unordered" + suffix, [&]() {
+                keep(unordered.getMove(&searchBoard).first);
+                return unordered.getLastNodeCount();
+            }, [&]() { unordered.clearTranspositionTable(); });
+        }
+    }
+    return 0;
+}
@@ -1,89 +1,331 @@
 #include "Board.h"
+#include "Zobrist.h"
+#include <algorithm>
 
-Board::Board()
+Board::Board(int size, int winLength)
+    : size(std::clamp(size, MIN_SIZE, MAX_SIZE)),
+      winLength(std::clamp(winLength, MIN_SIZE, this->size)), symmetryHashing(false)
 {
     reset();
 }
 
 void Board::reset()
 {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            board[i][j] = ' ';
-        }
-    }
+    moveCount = 0;
+    xBits.reset();
+    oBits.reset();
+    xWon = false;
+    oWon = false;
+    xWinCell = -1;
+    oWinCell = -1;
+    hashes.fill(0);
 }
 
 bool Board::makeMove(int row, int col, char player)
 {
     if (isValidMove(row, col)) {
-        board[row][col] = player;
+        int cell = row * size + col;
+        if (player == 'X') {
+            xBits.set(cell);
+            toggleHashes(cell, 0);
+            if (!xWon && completesLine(row, col, 'X')) {
+                xWon = true;
+                xWinCell = cell;
+            }
+        } else if (player == 'O') {
+            oBits.set(cell);
+            toggleHashes(cell, 1);
+            if (!oWon && completesLine(row, col, 'O')) {
+                oWon = true;
+                oWinCell = cell;
+            }
+        } else {
+            return false;
+        }
+        ++moveCount;
         return true;
     }
     return false;
 }
 
-bool Board::isValidMove(int row, int col) const
+bool Board::undoMove(int row, int col)
 {
-    return (row >= 0 && row < 3 && col >= 0 && col < 3 && board[row][col] == ' ');
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return false;
+    }
+
+    int cell = row * size + col;
+    if (xBits.test(cell)) {
+        xBits.reset(cell);
+        toggleHashes(cell, 0);
+        if (cell == xWinCell) {
+            xWon = false;
+            xWinCell = -1;
+        }
+    } else if (oBits.test(cell)) {
+        oBits.reset(cell);
+        toggleHashes(cell, 1);
+        if (cell == oWinCell) {
+            oWon = false;
+            oWinCell = -1;
+        }
+    } else {
+        return false;
+    }
+    --moveCount;
+    return true;
 }
 
-bool Board::checkWin(char player) const
+void Board::toggleHashes(int cell, int side)
 {
-    // Check rows
-    for (int i = 0; i < 3; ++i) {
-        if (board[i][0] == player && board[i][1] == player && board[i][2] == player) {
-            return true;
+    hashes[0] ^= Zobrist::cellKey(cell, side);
+    if (symmetryHashing) {
+        const auto& permutations = Symmetry::PERMUTATIONS[size];
+        for (int sym = 1; sym < Symmetry::COUNT; ++sym) {
+            hashes[sym] ^= Zobrist::cellKey(permutations[sym][cell], side);
         }
     }
+}
 
-    // Check columns
-    for (int j = 0; j < 3; ++j) {
-        if (board[0][j] == player && board[1][j] == player && board[2][j] == player) {
-            return true;
+// The hash under one symmetry, built from the stones
+uint64_t Board::hashUnder(int sym) const
+{
+    const auto& permutation = Symmetry::PERMUTATIONS[size][sym];
+    uint64_t hash = 0;
+    for (int cell = 0; cell < size * size; ++cell) {
+        if (xBits[cell]) {
+            hash ^= Zobrist::cellKey(permutation[cell], 0);
+        } else if (oBits[cell]) {
+            hash ^= Zobrist::cellKey(permutation[cell], 1);
         }
     }
+    return hash;
+}
 
-    // Check diagonals
-    if (board[0][0] == player && board[1][1] == player && board[2][2] == player) {
-        return true;
+void Board::setSymmetryHashing(bool enabled)
+{
+    symmetryHashing = enabled;
+    if (enabled) {
+        for (int sym = 1; sym < Symmetry::COUNT; ++sym) {
+            hashes[sym] = hashUnder(sym);
+        }
     }
-    if (board[0][2] == player && board[1][1] == player && board[2][0] == player) {
-        return true;
+}
+
+uint64_t Board::getCanonicalHash() const
+{
+    if (symmetryHashing) {
+        return *std::min_element(hashes.begin(), hashes.end());
+    }
+    uint64_t lowest = hashes[0];
+    for (int sym = 1; sym < Symmetry::COUNT; ++sym) {
+        lowest = std::min(lowest, hashUnder(sym));
     }
+    return lowest;
+}
 
-    return false;
+// Hashes, when kept, only rule a symmetry out; a match is confirmed stone
+// by stone
+bool Board::hasSymmetry(int sym) const
+{
+    if (symmetryHashing && hashes[sym] != hashes[0]) {
+        return false;
+    }
+    const auto& permutation = Symmetry::PERMUTATIONS[size][sym];
+    for (int cell = 0; cell < size * size; ++cell) {
+        if (xBits.test(cell) != xBits.test(permutation[cell]) ||
+            oBits.test(cell) != oBits.test(permutation[cell])) {
+            return false;
+        }
+    }
+    return true;
 }
 
-bool Board::checkTie() const
+void Board::removeSymmetricMoves(MoveList& moves) const
 {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            if (board[i][j] == ' ') {
-                return false;
+    int representatives[MAX_CELLS];
+    findSymmetricMoves(moves, representatives);
+
+    int kept = 0;
+    for (int i = 0; i < moves.size(); ++i) {
+        if (representatives[i] == i) {
+            moves[kept++] = moves[i];
+        }
+    }
+    moves.truncate(kept);
+}
+
+void Board::findSymmetricMoves(const MoveList& moves, int representatives[]) const
+{
+    int symmetries[Symmetry::COUNT];
+    int count = 0;
+    for (int sym = 1; sym < Symmetry::COUNT; ++sym) {
+        if (hasSymmetry(sym)) {
+            symmetries[count++] = sym;
+        }
+    }
+
+    // A move is a duplicate only if a symmetry of the position maps it onto
+    // an earlier move in the list. Comparing against cells outside the list
+    // would lose every copy of a move, e.g. the lone centre candidate of an
+    // even board.
+    int keptAt[MAX_CELLS];
+    std::fill(keptAt, keptAt + size * size, -1);
+    for (int i = 0; i < moves.size(); ++i) {
+        int cell = moves[i].row * size + moves[i].col;
+        representatives[i] = i;
+        for (int j = 0; j < count; ++j) {
+            int earlier = keptAt[Symmetry::PERMUTATIONS[size][symmetries[j]][cell]];
+            if (earlier >= 0) {
+                representatives[i] = earlier;
+                break;
             }
         }
+        if (representatives[i] == i) {
+            keptAt[cell] = i;
+        }
     }
-    return !checkWin('X') && !checkWin('O');
+}
+
+bool Board::completesLine(int row, int col, char player) const
+{
+    // countLine starts from (row, col) itself, so the cell need not be set
+    const Bitboard& bits = player == 'X' ? xBits : oBits;
+    return countLine(bits, row, col, 0, 1) >= winLength ||
+           countLine(bits, row, col, 1, 0) >= winLength ||
+           countLine(bits, row, col, 1, 1) >= winLength ||
+           countLine(bits, row, col, 1, -1) >= winLength;
+}
+
+// Length of the run through (row, col) along one direction, looking at most
+// winLength - 1 cells each way, so a win test costs O(winLength)
+int Board::countLine(const Bitboard& bits, int row, int col, int dRow, int dCol) const
+{
+    int count = 1;
+    for (int step = 1; step < winLength; ++step) {
+        int r = row + dRow * step;
+        int c = col + dCol * step;
+        if (r < 0 || r >= size || c < 0 || c >= size || !bits[r * size + c]) {
+            break;
+        }
+        ++count;
+    }
+    for (int step = 1; step < winLength; ++step) {
+        int r = row - dRow * step;
+        int c = col - dCol * step;
+        if (r < 0 || r >= size || c < 0 || c >= size || !bits[r * size + c]) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+bool Board::isValidMove(int row, int col) const
+{
+    return (row >= 0 && row < size && col >= 0 && col < size &&
+            !xBits.test(row * size + col) && !oBits.test(row * size + col));
+}
+
+bool Board::checkWin(char player) const
+{
+    if (player == 'X') {
+        return xWon;
+    }
+    if (player == 'O') {
+        return oWon;
+    }
+    return false;
+}
+
+bool Board::checkTie() const
+{
+    return moveCount == size * size && !xWon && !oWon;
 }
 
 std::vector<std::pair<int, int>> Board::getAvailableMoves() const
 {
     std::vector<std::pair<int, int>> moves;
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            if (board[i][j] == ' ') {
-                moves.push_back(std::make_pair(i, j));
-            }
+    Bitboard occupied = xBits | oBits;
+    moves.reserve(size * size - moveCount);
+    for (int i = 0; i < size * size; ++i) {
+        if (!occupied.test(i)) {
+            moves.push_back(std::make_pair(i / size, i % size));
         }
     }
     return moves;
 }
 
+void Board::generateMoves(MoveList& moves) const
+{
+    moves.clear();
+    Bitboard occupied = xBits | oBits;
+    for (int i = 0; i < size * size; ++i) {
+        if (!occupied.test(i)) {
+            moves.push(i / size, i % size);
+        }
+    }
+}
+
+void Board::generateCandidateMoves(MoveList& moves) const
+{
+    if (isClassic()) {
+        generateMoves(moves);
+        return;
+    }
+
+    moves.clear();
+    Bitboard occupied = xBits | oBits;
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            if (occupied.test(row * size + col)) {
+                continue;
+            }
+            bool nearStone = false;
+            for (int dr = -1; dr <= 1 && !nearStone; ++dr) {
+                for (int dc = -1; dc <= 1 && !nearStone; ++dc) {
+                    int r = row + dr;
+                    int c = col + dc;
+                    nearStone = r >= 0 && r < size && c >= 0 && c < size &&
+                                occupied.test(r * size + c);
+                }
+            }
+            if (nearStone) {
+                moves.push(row, col);
+            }
+        }
+    }
+
+    if (moves.empty() && !occupied.test((size / 2) * size + size / 2)) {
+        moves.push(size / 2, size / 2);
+    }
+    if (moves.empty()) {
+        generateMoves(moves);
+    }
+}
+
 char Board::getCell(int row, int col) const
 {
-    if (row >= 0 && row < 3 && col >= 0 && col < 3) {
-        return board[row][col];
+    if (row >= 0 && row < size && col >= 0 && col < size) {
+        int cell = row * size + col;
+        if (xBits.test(cell)) {
+            return 'X';
+        }
+        if (oBits.test(cell)) {
+            return 'O';
+        }
     }
     return ' ';
 }
+
+uint16_t Board::getMask(char player) const
+{
+    if (!isClassic()) {
+        return 0;
+    }
+    if (player != 'X' && player != 'O') {
+        return 0;
+    }
+    const Bitboard& bits = player == 'X' ? xBits : oBits;
+    return static_cast<uint16_t>((bits & Bitboard(FULL_MASK)).to_ulong());
+}
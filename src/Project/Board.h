@@ -3,22 +3,128 @@
 
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <bitset>
+#include <array>
+#include "Symmetry.h"
+
+struct Move
+{
+    int row;
+    int col;
+};
+
+class MoveList;
 
 class Board
 {
 public:
-    Board();
+    static constexpr int MIN_SIZE = 3;
+    static constexpr int MAX_SIZE = 16;
+    static constexpr int MAX_CELLS = MAX_SIZE * MAX_SIZE;
+    using Bitboard = std::bitset<MAX_CELLS>;
+
+    // size x size board, won by winLength stones in a row
+    Board(int size = 3, int winLength = 3);
 
     bool makeMove(int row, int col, char player);
+    // Takes back the stone at (row, col); the search pairs it with makeMove
+    bool undoMove(int row, int col);
     bool checkWin(char player) const;
+    // Whether a stone of `player` on the empty cell (row, col) would
+    // complete a line
+    bool completesLine(int row, int col, char player) const;
     bool checkTie() const;
     std::vector<std::pair<int, int>> getAvailableMoves() const;
+    void generateMoves(MoveList& moves) const;
+    // Moves worth searching: every empty cell on 3x3, otherwise only cells
+    // touching a stone (the centre on an empty board)
+    void generateCandidateMoves(MoveList& moves) const;
     void reset();
     char getCell(int row, int col) const;
+    uint64_t getHash() const { return hashes[0]; }
+    // Same for every rotation and reflection of this position. Cheap only
+    // with symmetry hashing on; otherwise the other seven are rebuilt here.
+    uint64_t getCanonicalHash() const;
+    // Keeps the hash under every symmetry up to date on each move, for
+    // searches that look positions up by canonical hash. Off by default, so
+    // other moves only update the plain hash.
+    void setSymmetryHashing(bool enabled);
+    // Drops moves that lead to the same position as an earlier move up to
+    // symmetry; only positions with a symmetry of their own lose any
+    void removeSymmetricMoves(MoveList& moves) const;
+    // For each move, the index of the earliest move that leads to the same
+    // position up to symmetry: its own index unless an earlier one does
+    void findSymmetricMoves(const MoveList& moves, int representatives[]) const;
+
+    int getSize() const { return size; }
+    int getWinLength() const { return winLength; }
+    int getMoveCount() const { return moveCount; }
+    bool isClassic() const { return size == 3 && winLength == 3; }
+
+    // Classic 3x3 layout of a side's stones (bit i is cell (i / 3, i % 3))
+    uint16_t getMask(char player) const;
+
+    // Classic 3x3 winning lines, used by the compile-time perfect-play table
+    static constexpr uint16_t FULL_MASK = 0x1FF;
+    static constexpr uint16_t WIN_MASKS[8] = {
+        0x007, 0x038, 0x1C0,   // rows
+        0x049, 0x092, 0x124,   // columns
+        0x111, 0x054           // diagonals
+    };
+
+    static constexpr bool isWinningMask(uint16_t mask)
+    {
+        for (uint16_t winMask : WIN_MASKS) {
+            if ((mask & winMask) == winMask) {
+                return true;
+            }
+        }
+        return false;
+    }
 
 private:
-    char board[3][3];
+    int size;
+    int winLength;
+    int moveCount;
+    Bitboard xBits;
+    Bitboard oBits;
+    bool xWon;
+    bool oWon;
+    int xWinCell;   // stone that completed the first X line, -1 if none
+    int oWinCell;
+    std::array<uint64_t, Symmetry::COUNT> hashes;   // Zobrist hash under each symmetry
+    bool symmetryHashing;   // hashes[1..] are only kept while this is set
     bool isValidMove(int row, int col) const;
+    int countLine(const Bitboard& bits, int row, int col, int dRow, int dCol) const;
+    void toggleHashes(int cell, int side);
+    uint64_t hashUnder(int sym) const;
+    bool hasSymmetry(int sym) const;
+};
+
+// Fixed-capacity move list so move generation never touches the heap
+class MoveList
+{
+public:
+    MoveList() : count(0) {}
+
+    void push(int row, int col) { moves[count++] = Move{row, col}; }
+    void clear() { count = 0; }
+    // Keeps the first `newSize` moves
+    void truncate(int newSize) { count = newSize; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    Move& operator[](int index) { return moves[index]; }
+    const Move& operator[](int index) const { return moves[index]; }
+    Move* begin() { return moves.data(); }
+    Move* end() { return moves.data() + count; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + count; }
+
+private:
+    std::array<Move, Board::MAX_CELLS> moves;
+    int count;
 };
 
 #endif // BOARD_H
@@ -0,0 +1,72 @@
+#include "BoardCell.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmapCache>
+
+BoardCell::BoardCell(int row, int col, QWidget* parent)
+    : QPushButton(parent), cellRow(row), cellCol(col), cellMark(0)
+{
+}
+
+void BoardCell::setMark(char mark)
+{
+    if (mark != cellMark) {
+        cellMark = mark;
+        update();
+    }
+}
+
+void BoardCell::paintEvent(QPaintEvent* event)
+{
+    // The styled background and border, with no text
+    QPushButton::paintEvent(event);
+    if (!cellMark) {
+        return;
+    }
+
+    int size = qMin(width(), height()) * 3 / 5;
+    if (size <= 0) {
+        return;
+    }
+    QPixmap pixmap = glyph(cellMark, size, devicePixelRatioF());
+    QPainter painter(this);
+    painter.drawPixmap((width() - size) / 2, (height() - size) / 2, pixmap);
+}
+
+// Drawn once per mark, size and screen scale: a few wide translucent
+// strokes for the neon glow under the solid letter
+QPixmap BoardCell::glyph(char mark, int size, qreal devicePixelRatio)
+{
+    QString key = QString("boardcell:%1:%2:%3").arg(mark).arg(size).arg(devicePixelRatio);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    pixmap = QPixmap(QSize(size, size) * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QColor color = mark == 'X' ? QColor("#FF1493") : QColor("#00FFFF");
+    QFont font;
+    font.setBold(true);
+    font.setPixelSize(size * 7 / 10);
+    QPainterPath path;
+    path.addText(0, 0, font, QString(QLatin1Char(mark)));
+    QRectF bounds = path.boundingRect();
+    path.translate(size / 2.0 - bounds.center().x(), size / 2.0 - bounds.center().y());
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int pass = 3; pass >= 1; --pass) {
+        QColor glow = color;
+        glow.setAlpha(40);
+        painter.strokePath(path, QPen(glow, size / 12.0 * pass, Qt::SolidLine, Qt::RoundCap,
+                                      Qt::RoundJoin));
+    }
+    painter.fillPath(path, color);
+    painter.end();
+
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
@@ -0,0 +1,35 @@
+#ifndef BOARDCELL_H
+#define BOARDCELL_H
+
+#include <QPushButton>
+#include <QPixmap>
+
+// One square of the game grid. Background and border come from the
+// #gameButton stylesheet rules, which are polished once when the cell is
+// created; the X or O is painted from a glyph pixmap cached per mark and
+// size, so placing a stone costs one repaint and never touches a stylesheet.
+class BoardCell : public QPushButton
+{
+    Q_OBJECT
+
+public:
+    BoardCell(int row, int col, QWidget* parent = nullptr);
+
+    int row() const { return cellRow; }
+    int col() const { return cellCol; }
+    char mark() const { return cellMark; }
+    // 'X', 'O', or 0 for an empty cell
+    void setMark(char mark);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    static QPixmap glyph(char mark, int size, qreal devicePixelRatio);
+
+    int cellRow;
+    int cellCol;
+    char cellMark;
+};
+
+#endif // BOARDCELL_H
@@ -0,0 +1,648 @@
+#include "GameHistoryStore.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtEndian>
+#include <algorithm>
+#include <array>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+// File layout: 8-byte magic, then records of
+// [payload length: u32][crc32 of type + payload: u32][type: u8][payload]
+const char MAGIC[8] = {'T', 'T', 'T', 'H', 'I', 'S', 'T', '1'};
+constexpr qint64 HEADER_SIZE = sizeof(MAGIC);
+constexpr qint64 RECORD_OVERHEAD = 9;
+constexpr quint32 MAX_PAYLOAD = 16 * 1024 * 1024;
+
+// Index checkpoint: magic, version, log size it covers, next id, then per
+// player the name, its games (id, offset, winner, vs AI) and its stats
+constexpr quint32 INDEX_MAGIC = 0x54494458; // "TIDX"
+constexpr quint32 INDEX_VERSION = 3;
+constexpr int CHECKPOINT_INTERVAL = 64;
+
+constexpr std::array<quint32, 256> makeCrcTable()
+{
+    std::array<quint32, 256> table{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> CRC_TABLE = makeCrcTable();
+
+quint32 crc32(quint8 type, const QByteArray& payload)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    crc = CRC_TABLE[(crc ^ type) & 0xFF] ^ (crc >> 8);
+    for (char byte : payload) {
+        crc = CRC_TABLE[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Single digits keep the original "X12" form; larger boards need a separator
+QString formatMove(char player, int row, int col, int boardSize)
+{
+    if (boardSize <= 10) {
+        return QString("%1%2%3").arg(player).arg(row).arg(col);
+    }
+    return QString("%1%2,%3").arg(player).arg(row).arg(col);
+}
+
+// Reads moves in the string form; only the cells are kept, as X always
+// moves first and the players alternate
+bool parseMoves(const QStringList& moves, int boardSize, MoveSequence& sequence)
+{
+    sequence = MoveSequence(boardSize);
+    for (const QString& move : moves) {
+        int row = -1;
+        int col = -1;
+        if (move.size() < 3) {
+            return false;
+        }
+        if (move.contains(',')) {
+            QStringList parts = move.mid(1).split(',');
+            bool rowOk = false;
+            bool colOk = false;
+            row = parts.value(0).toInt(&rowOk);
+            col = parts.value(1).toInt(&colOk);
+            if (!rowOk || !colOk) {
+                return false;
+            }
+        } else {
+            row = move[1].digitValue();
+            col = move[2].digitValue();
+        }
+        if (row < 0 || col < 0 || row >= boardSize || col >= boardSize) {
+            return false;
+        }
+        sequence.append(row, col);
+    }
+    return true;
+}
+
+GameHistoryStore::GameRef makeRef(const GameRecord& record, qint64 offset)
+{
+    GameHistoryStore::GameRef ref;
+    ref.id = record.id;
+    ref.offset = offset;
+    ref.winner = record.winner.isEmpty() ? 'T' : record.winner.at(0).toLatin1();
+    ref.vsAI = record.mode == "PvAI";
+    return ref;
+}
+}
+
+GameHistoryStore::GameHistoryStore(const QString& path, SyncPolicy policy)
+    : path(path), file(path), syncPolicy(policy), nextId(1), appendsSinceCheckpoint(0)
+{
+}
+
+GameHistoryStore::~GameHistoryStore()
+{
+    close();
+}
+
+bool GameHistoryStore::open()
+{
+    if (file.isOpen()) {
+        return true;
+    }
+
+    // A log with no records yet takes over the old JSON history once. If the
+    // import fails the log stays empty and it is tried again next time.
+    QFileInfo info(path);
+    QString legacyPath = info.absolutePath() + "/game_history.json";
+    if ((!info.exists() || info.size() <= HEADER_SIZE) && QFileInfo::exists(legacyPath)) {
+        importLegacyHistory(legacyPath);
+    }
+    return openLog();
+}
+
+bool GameHistoryStore::openLog()
+{
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    index.clear();
+    stats.clear();
+    nextId = 1;
+    appendsSinceCheckpoint = 0;
+
+    // Shorter than a header means the very first write was cut short
+    bool ok;
+    if (file.size() < HEADER_SIZE) {
+        ok = file.resize(0) && writeHeader();
+    } else {
+        // Without a usable checkpoint the index is rebuilt from the header
+        qint64 coveredSize = HEADER_SIZE;
+        if (!loadIndex(coveredSize)) {
+            index.clear();
+            stats.clear();
+            nextId = 1;
+            coveredSize = HEADER_SIZE;
+        }
+        ok = recover(coveredSize);
+    }
+    if (!ok) {
+        file.close();
+    }
+    return ok;
+}
+
+// The import is built in a staging file and renamed over the log only once
+// it is complete and on disk, so a crash part-way never leaves half of the
+// old history in the log. The JSON file is renamed last.
+bool GameHistoryStore::importLegacyHistory(const QString& legacyPath)
+{
+    QString stagingPath = path + ".migrating";
+    QFile::remove(stagingPath);
+
+    GameHistoryStore staging(stagingPath, SyncOnClose);
+    if (!staging.openLog() || !staging.migrateFromJson(legacyPath)) {
+        staging.close();
+        QFile::remove(stagingPath);
+        return false;
+    }
+    staging.close();
+
+    QFile::remove(path);
+    QFile::remove(indexPath());
+    if (!QFile::rename(stagingPath, path)) {
+        QFile::remove(staging.indexPath());
+        return false;
+    }
+    // The staging index describes the same bytes; if it is lost the index
+    // is simply rebuilt on open
+    QFile::rename(staging.indexPath(), indexPath());
+    QFile::rename(legacyPath, legacyPath + ".migrated");
+    return true;
+}
+
+void GameHistoryStore::close()
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    if (appendsSinceCheckpoint > 0 || !QFileInfo::exists(indexPath())) {
+        saveIndex();
+    } else if (syncPolicy != SyncNever) {
+        syncToDisk();
+    }
+    file.close();
+}
+
+bool GameHistoryStore::writeHeader()
+{
+    if (file.write(MAGIC, HEADER_SIZE) != HEADER_SIZE) {
+        return false;
+    }
+    return syncPolicy == SyncNever ? file.flush() : syncToDisk();
+}
+
+// Replays the records from `from` (the header or the end of the index
+// checkpoint) into the index to find the end of the valid log. A record that
+// runs past the end of the file or fails its checksum can only be a write
+// that was cut short, so it and anything after it are truncated away.
+bool GameHistoryStore::recover(qint64 from)
+{
+    char magic[HEADER_SIZE];
+    if (!file.seek(0) || file.read(magic, HEADER_SIZE) != HEADER_SIZE ||
+        QByteArray(magic, HEADER_SIZE) != QByteArray(MAGIC, HEADER_SIZE) || !file.seek(from)) {
+        return false;
+    }
+
+    qint64 validEnd = from;
+    quint8 type = 0;
+    QByteArray payload;
+    while (readRecord(file, type, payload)) {
+        applyRecord(type, payload, validEnd);
+        validEnd = file.pos();
+        ++appendsSinceCheckpoint;
+    }
+
+    // A bad record right after a checkpoint may mean the checkpoint does not
+    // match this log, so rebuild from the header before truncating anything
+    if (validEnd < file.size() && from > HEADER_SIZE) {
+        index.clear();
+        stats.clear();
+        nextId = 1;
+        appendsSinceCheckpoint = 0;
+        return recover(HEADER_SIZE);
+    }
+
+    if (validEnd < file.size()) {
+        if (!file.resize(validEnd)) {
+            return false;
+        }
+        syncToDisk();
+    }
+    return file.seek(validEnd);
+}
+
+// Updates the index for one record that starts at `offset`
+void GameHistoryStore::applyRecord(quint8 type, const QByteArray& payload, qint64 offset)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint64 id = 0;
+    QString owner;
+
+    if (type == GameRecordType) {
+        GameRecord record;
+        if (decodeGame(payload, record)) {
+            index[record.player].append(makeRef(record, offset));
+            stats[record.player].addGame(record);
+            nextId = qMax(nextId, record.id + 1);
+        }
+    } else if (type == DeleteRecordType) {
+        in >> owner >> id;
+        auto it = index.find(owner);
+        if (it != index.end()) {
+            QVector<GameRef>& entries = it.value();
+            for (int i = 0; i < entries.size(); ++i) {
+                if (entries[i].id == id) {
+                    entries.removeAt(i);
+                    break;
+                }
+            }
+            if (entries.isEmpty()) {
+                index.erase(it);
+            }
+        }
+        rebuildStats(owner);
+    } else if (type == ClearRecordType) {
+        in >> owner;
+        index.remove(owner);
+        stats.remove(owner);
+    }
+}
+
+// Streaks cannot be unwound, so a delete replays the player's remaining games
+void GameHistoryStore::rebuildStats(const QString& player)
+{
+    PlayerStats rebuilt;
+    for (const GameRecord& game : loadGames(player)) {
+        rebuilt.addGame(game);
+    }
+    if (rebuilt.overall.total() > 0) {
+        stats.insert(player, rebuilt);
+    } else {
+        stats.remove(player);
+    }
+}
+
+bool GameHistoryStore::loadIndex(qint64& coveredSize)
+{
+    QFile source(indexPath());
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&source);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 size = 0;
+    quint64 storedNextId = 1;
+    quint32 playerCount = 0;
+    in >> magic >> version >> size >> storedNextId >> playerCount;
+    // A checkpoint past the end of the log belongs to some other log
+    if (in.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION ||
+        size < HEADER_SIZE || size > file.size()) {
+        return false;
+    }
+
+    QHash<QString, QVector<GameRef>> loaded;
+    QHash<QString, PlayerStats> loadedStats;
+    loaded.reserve(playerCount);
+    loadedStats.reserve(playerCount);
+    for (quint32 p = 0; p < playerCount && in.status() == QDataStream::Ok; ++p) {
+        QString player;
+        quint32 count = 0;
+        in >> player >> count;
+        QVector<GameRef>& entries = loaded[player];
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            GameRef entry;
+            qint8 winner = 'T';
+            in >> entry.id >> entry.offset >> winner >> entry.vsAI;
+            entry.winner = static_cast<char>(winner);
+            entries.append(entry);
+        }
+        in >> loadedStats[player];
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    index.swap(loaded);
+    stats.swap(loadedStats);
+    nextId = storedNextId;
+    coveredSize = size;
+    return true;
+}
+
+// The log is synced first so the checkpoint never covers bytes that could
+// still be lost, and QSaveFile replaces the old checkpoint atomically
+bool GameHistoryStore::saveIndex()
+{
+    if (!file.isOpen() || !syncToDisk()) {
+        return false;
+    }
+
+    QSaveFile target(indexPath());
+    if (!target.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&target);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << INDEX_MAGIC << INDEX_VERSION << file.size() << nextId << quint32(index.size());
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        out << it.key() << quint32(it.value().size());
+        for (const GameRef& entry : it.value()) {
+            out << entry.id << entry.offset << qint8(entry.winner) << entry.vsAI;
+        }
+        out << stats.value(it.key());
+    }
+    if (out.status() != QDataStream::Ok || !target.commit()) {
+        return false;
+    }
+    appendsSinceCheckpoint = 0;
+    return true;
+}
+
+bool GameHistoryStore::readRecord(QFile& source, quint8& type, QByteArray& payload)
+{
+    uchar header[RECORD_OVERHEAD];
+    if (source.read(reinterpret_cast<char*>(header), RECORD_OVERHEAD) != RECORD_OVERHEAD) {
+        return false;
+    }
+    quint32 length = qFromLittleEndian<quint32>(header);
+    quint32 checksum = qFromLittleEndian<quint32>(header + 4);
+    type = header[8];
+    if (length > MAX_PAYLOAD) {
+        return false;
+    }
+
+    payload = source.read(length);
+    return payload.size() == static_cast<int>(length) && crc32(type, payload) == checksum;
+}
+
+bool GameHistoryStore::appendRecord(RecordType type, const QByteArray& payload, qint64* offset)
+{
+    if (!file.isOpen() && !open()) {
+        return false;
+    }
+
+    uchar header[RECORD_OVERHEAD];
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header);
+    qToLittleEndian<quint32>(crc32(type, payload), header + 4);
+    header[8] = type;
+
+    // One write per record keeps a crash from interleaving header and payload
+    QByteArray bytes(reinterpret_cast<const char*>(header), RECORD_OVERHEAD);
+    bytes.append(payload);
+    qint64 start = file.size();
+    if (!file.seek(start) || file.write(bytes) != bytes.size()) {
+        return false;
+    }
+    if (offset) {
+        *offset = start;
+    }
+
+    // Always hand the record to the OS: loadGames reads through its own handle
+    bool ok = syncPolicy == SyncEveryRecord ? syncToDisk() : file.flush();
+    if (ok && ++appendsSinceCheckpoint >= CHECKPOINT_INTERVAL) {
+        saveIndex();
+    }
+    return ok;
+}
+
+bool GameHistoryStore::syncToDisk()
+{
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+bool GameHistoryStore::appendGame(GameRecord& record)
+{
+    record.id = nextId;
+    qint64 offset = 0;
+    if (!appendRecord(GameRecordType, encodeGame(record), &offset)) {
+        return false;
+    }
+    index[record.player].append(makeRef(record, offset));
+    stats[record.player].addGame(record);
+    ++nextId;
+    return true;
+}
+
+bool GameHistoryStore::deleteGame(const QString& player, quint64 id)
+{
+    // Unknown games are rejected without touching the log
+    const QVector<GameRef> entries = index.value(player);
+    auto known = std::find_if(entries.begin(), entries.end(),
+                              [id](const GameRef& entry) { return entry.id == id; });
+    if (known == entries.end()) {
+        return false;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << player << id;
+    if (!appendRecord(DeleteRecordType, payload)) {
+        return false;
+    }
+    applyRecord(DeleteRecordType, payload, 0);
+    return true;
+}
+
+bool GameHistoryStore::clearPlayer(const QString& player)
+{
+    if (!index.contains(player)) {
+        return true;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << player;
+    if (!appendRecord(ClearRecordType, payload)) {
+        return false;
+    }
+    index.remove(player);
+    stats.remove(player);
+    return true;
+}
+
+// Reads only the player's own records, at the offsets kept in the index
+QVector<GameRecord> GameHistoryStore::loadGames(const QString& player) const
+{
+    return loadGames(index.value(player));
+}
+
+QVector<GameRecord> GameHistoryStore::loadGames(const QVector<GameRef>& refs) const
+{
+    QVector<GameRecord> games;
+    QFile source(path);
+    if (refs.isEmpty() || !source.open(QIODevice::ReadOnly)) {
+        return games;
+    }
+    games.reserve(refs.size());
+    quint8 type = 0;
+    QByteArray payload;
+    for (const GameRef& ref : refs) {
+        GameRecord record;
+        if (source.seek(ref.offset) && readRecord(source, type, payload) &&
+            type == GameRecordType && decodeGame(payload, record) && record.id == ref.id) {
+            games.append(record);
+        }
+    }
+    return games;
+}
+
+int GameHistoryStore::gameCount(const QString& player) const
+{
+    auto it = index.constFind(player);
+    return it == index.constEnd() ? 0 : it.value().size();
+}
+
+// Strings are stored as UTF-8 and the enum-like fields as single bytes, so
+// a 3x3 game takes a few dozen bytes
+QByteArray GameHistoryStore::encodeGame(const GameRecord& record)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    const std::vector<uint8_t>& moves = record.moves.getBytes();
+    out << record.id << record.player.toUtf8() << record.opponent.toUtf8()
+        << record.difficulty.toUtf8()
+        << qint8(record.winner.isEmpty() ? 'T' : record.winner.at(0).toLatin1())
+        << (record.mode == "PvAI") << quint8(record.boardSize) << quint8(record.winLength)
+        << quint16(record.moves.size())
+        << QByteArray(reinterpret_cast<const char*>(moves.data()), static_cast<int>(moves.size()));
+    return payload;
+}
+
+bool GameHistoryStore::decodeGame(const QByteArray& payload, GameRecord& record)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    QByteArray player, opponent, difficulty, moves;
+    qint8 winner = 'T';
+    bool vsAI = false;
+    quint8 boardSize = 3;
+    quint8 winLength = 3;
+    quint16 moveCount = 0;
+    in >> record.id >> player >> opponent >> difficulty >> winner >> vsAI >> boardSize
+       >> winLength >> moveCount >> moves;
+    record.player = QString::fromUtf8(player);
+    record.opponent = QString::fromUtf8(opponent);
+    record.difficulty = QString::fromUtf8(difficulty);
+    record.winner = QString(QLatin1Char(winner));
+    record.mode = vsAI ? "PvAI" : "PvP";
+    record.boardSize = boardSize;
+    record.winLength = winLength;
+    return in.status() == QDataStream::Ok &&
+           record.moves.assign(boardSize, moveCount,
+                               reinterpret_cast<const uchar*>(moves.constData()),
+                               static_cast<size_t>(moves.size()));
+}
+
+bool GameHistoryStore::migrateFromJson(const QString& jsonPath)
+{
+    QFile legacy(jsonPath);
+    if (!legacy.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonObject history = QJsonDocument::fromJson(legacy.readAll()).object();
+    legacy.close();
+
+    // Imported games are only made durable once, at the end
+    SyncPolicy policy = syncPolicy;
+    syncPolicy = SyncOnClose;
+    bool ok = true;
+    for (auto it = history.constBegin(); it != history.constEnd() && ok; ++it) {
+        const QJsonArray games = it.value().toArray();
+        for (const QJsonValue& value : games) {
+            QJsonObject gameData = value.toObject();
+            GameRecord record;
+            record.player = it.key();
+            record.winner = gameData["winner"].toString();
+            record.mode = gameData["mode"].toString();
+            record.opponent = gameData["opponent"].toString();
+            record.boardSize = gameData["boardSize"].toInt(3);
+            record.winLength = gameData["winLength"].toInt(3);
+            record.difficulty = gameData["difficulty"].toString();
+            QStringList moves;
+            for (const QJsonValue& move : gameData["moves"].toArray()) {
+                moves.append(move.toString());
+            }
+            // A game whose moves cannot be read is skipped, not imported empty
+            if (!parseMoves(moves, record.boardSize, record.moves)) {
+                continue;
+            }
+            if (!appendGame(record)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    syncPolicy = policy;
+    return syncToDisk() && ok;
+}
+
+bool GameHistoryStore::exportJson(const QString& player, const QString& jsonPath) const
+{
+    QJsonArray games;
+    for (const GameRecord& record : loadGames(player)) {
+        QJsonArray moves;
+        for (int i = 0; i < record.moves.size(); ++i) {
+            Move move = record.moves.at(i);
+            moves.append(formatMove(MoveSequence::playerAt(i), move.row, move.col, record.boardSize));
+        }
+
+        QJsonObject gameData;
+        gameData["winner"] = record.winner;
+        gameData["mode"] = record.mode;
+        gameData["opponent"] = record.opponent;
+        gameData["boardSize"] = record.boardSize;
+        gameData["winLength"] = record.winLength;
+        if (!record.difficulty.isEmpty()) {
+            gameData["difficulty"] = record.difficulty;
+        }
+        gameData["moves"] = moves;
+        games.append(gameData);
+    }
+
+    QJsonObject history;
+    history[player] = games;
+    QSaveFile target(jsonPath);
+    if (!target.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    target.write(QJsonDocument(history).toJson());
+    return target.commit();
+}
@@ -0,0 +1,121 @@
+#ifndef GAMEHISTORYSTORE_H
+#define GAMEHISTORYSTORE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QFile>
+#include <QHash>
+#include "PlayerStats.h"
+#include "MoveSequence.h"
+
+// One finished game as kept in the history
+struct GameRecord {
+    quint64 id = 0;         // assigned by the store, increasing
+    QString player;         // logged-in user, always X
+    QString winner;         // "X", "O" or "T"
+    QString mode;           // "PvP" or "PvAI"
+    QString opponent;
+    QString difficulty;     // "Easy", "Medium" or "Hard" in PvAI games
+    int boardSize = 3;
+    int winLength = 3;
+    MoveSequence moves;
+};
+
+// Append-only game history log. Every change is one record appended to
+// the file: a finished game, a deleted game or a cleared user. Records are
+// length-prefixed and checksummed, so a write cut short by a crash is
+// detected on open and the torn tail is dropped.
+//
+// A per-player index (player -> offsets of their live games) is kept in
+// memory and checkpointed to <log>.idx. Opening loads the checkpoint and
+// replays only the records written after it, and loading a player's games
+// reads just their records. Each player's PlayerStats are kept up to date
+// the same way and saved in the same checkpoint.
+class GameHistoryStore
+{
+public:
+    // Where one of a player's games sits in the log, with enough of the game
+    // to filter on without reading it
+    struct GameRef {
+        quint64 id = 0;
+        qint64 offset = 0;
+        char winner = 'T';
+        bool vsAI = false;
+    };
+
+    enum SyncPolicy {
+        SyncEveryRecord,   // fsync after every append; nothing acknowledged is lost
+        SyncOnClose,       // fsync only at index checkpoints and on close
+        SyncNever          // leave writing back to the OS
+    };
+
+    explicit GameHistoryStore(const QString& path = "game_history.log",
+                              SyncPolicy policy = SyncEveryRecord);
+    ~GameHistoryStore();
+
+    // Opens or creates the log, drops a torn tail and, for a new log,
+    // imports the old game_history.json once
+    bool open();
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    void setSyncPolicy(SyncPolicy policy) { syncPolicy = policy; }
+    SyncPolicy getSyncPolicy() const { return syncPolicy; }
+    // Forces everything appended so far onto the disk
+    bool sync() { return file.isOpen() && syncToDisk(); }
+
+    // Appends a game and fills in its id
+    bool appendGame(GameRecord& record);
+    bool deleteGame(const QString& player, quint64 id);
+    bool clearPlayer(const QString& player);
+
+    // A player's games, oldest first
+    QVector<GameRecord> loadGames(const QString& player) const;
+    QVector<GameRef> gameRefs(const QString& player) const { return index.value(player); }
+    int gameCount(const QString& player) const;
+    // Reads just the given games. Only touches the log through its own
+    // handle, so it may run while another thread appends.
+    QVector<GameRecord> loadGames(const QVector<GameRef>& refs) const;
+    PlayerStats playerStats(const QString& player) const { return stats.value(player); }
+    const QHash<QString, PlayerStats>& allPlayerStats() const { return stats; }
+
+    // Appends every game of {"user": [game, ...]}, the format written by
+    // earlier versions
+    bool migrateFromJson(const QString& jsonPath);
+    // Writes a player's games in that same JSON form, moves as "X12" strings
+    bool exportJson(const QString& player, const QString& jsonPath) const;
+
+private:
+    enum RecordType : quint8 {
+        GameRecordType = 1,     // moves as MoveSequence bytes
+        DeleteRecordType = 2,
+        ClearRecordType = 3
+    };
+
+    QString path;
+    QFile file;
+    SyncPolicy syncPolicy;
+    quint64 nextId;
+    QHash<QString, QVector<GameRef>> index;
+    QHash<QString, PlayerStats> stats;
+    int appendsSinceCheckpoint;
+
+    bool openLog();
+    bool importLegacyHistory(const QString& legacyPath);
+    bool writeHeader();
+    bool recover(qint64 from);
+    void applyRecord(quint8 type, const QByteArray& payload, qint64 offset);
+    void rebuildStats(const QString& player);
+    bool appendRecord(RecordType type, const QByteArray& payload, qint64* offset = nullptr);
+    bool syncToDisk();
+    QString indexPath() const { return path + ".idx"; }
+    bool loadIndex(qint64& coveredSize);
+    bool saveIndex();
+    static bool readRecord(QFile& source, quint8& type, QByteArray& payload);
+
+    static QByteArray encodeGame(const GameRecord& record);
+    static bool decodeGame(const QByteArray& payload, GameRecord& record);
+};
+
+#endif // GAMEHISTORYSTORE_H
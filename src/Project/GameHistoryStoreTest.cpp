@@ -0,0 +1,104 @@
+// Recovery tests for GameHistoryStore: a log cut short after an index
+// checkpoint must reopen with the same index and stats as the games that
+// survived.
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include "GameHistoryStore.h"
+
+class GameHistoryStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tornTailAfterCheckpoint();
+};
+
+namespace {
+// Checkpoints are written every 64 appends
+constexpr int CHECKPOINTED_GAMES = 64;
+constexpr int GAMES = CHECKPOINTED_GAMES + 6;
+
+GameRecord makeGame(int n)
+{
+    static const char* const winners[] = {"X", "O", "T", "X", "X"};
+    GameRecord game;
+    game.player = "alice";
+    game.winner = winners[n % 5];
+    game.mode = n % 2 == 0 ? "PvAI" : "PvP";
+    game.opponent = n % 2 == 0 ? "AI" : "bob";
+    game.difficulty = n % 2 == 0 ? "Hard" : "";
+    game.moves = MoveSequence(3);
+    for (int i = 0; i <= n % 5; ++i) {
+        game.moves.append(i / 3, i % 3);
+    }
+    return game;
+}
+
+void compareCounts(const ResultCounts& actual, const ResultCounts& expected)
+{
+    QCOMPARE(actual.wins, expected.wins);
+    QCOMPARE(actual.losses, expected.losses);
+    QCOMPARE(actual.ties, expected.ties);
+}
+}
+
+void GameHistoryStoreTest::tornTailAfterCheckpoint()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString logPath = dir.filePath("history.log");
+    QString indexPath = logPath + ".idx";
+
+    // Keep copies of the log and checkpoint as they stood before close()
+    // checkpoints again, as if the process had died there
+    {
+        GameHistoryStore store(logPath);
+        QVERIFY(store.open());
+        for (int n = 0; n < GAMES; ++n) {
+            GameRecord game = makeGame(n);
+            QVERIFY(store.appendGame(game));
+        }
+        QVERIFY(QFile::copy(logPath, logPath + ".crash"));
+        QVERIFY(QFile::copy(indexPath, indexPath + ".crash"));
+    }
+    QVERIFY(QFile::remove(logPath));
+    QVERIFY(QFile::remove(indexPath));
+    QVERIFY(QFile::rename(logPath + ".crash", logPath));
+    QVERIFY(QFile::rename(indexPath + ".crash", indexPath));
+
+    // Cut the last game short
+    {
+        QFile log(logPath);
+        QVERIFY(log.open(QIODevice::ReadWrite));
+        QVERIFY(log.resize(log.size() - 2));
+    }
+
+    PlayerStats expected;
+    for (int n = 0; n < GAMES - 1; ++n) {
+        expected.addGame(makeGame(n));
+    }
+
+    GameHistoryStore store(logPath);
+    QVERIFY(store.open());
+    QCOMPARE(store.gameCount("alice"), GAMES - 1);
+    QCOMPARE(store.loadGames("alice").size(), GAMES - 1);
+
+    PlayerStats stats = store.playerStats("alice");
+    compareCounts(stats.overall, expected.overall);
+    compareCounts(stats.byMode.value("PvAI"), expected.byMode.value("PvAI"));
+    compareCounts(stats.byOpponent.value("bob"), expected.byOpponent.value("bob"));
+    compareCounts(stats.byDifficulty.value("Hard"), expected.byDifficulty.value("Hard"));
+    QCOMPARE(stats.currentStreak, expected.currentStreak);
+    QCOMPARE(stats.longestWinStreak, expected.longestWinStreak);
+    QCOMPARE(stats.totalMoves, expected.totalMoves);
+
+    // The next game continues from the surviving ones
+    GameRecord game = makeGame(GAMES - 1);
+    QVERIFY(store.appendGame(game));
+    QCOMPARE(store.playerStats("alice").overall.total(), GAMES);
+}
+
+QTEST_APPLESS_MAIN(GameHistoryStoreTest)
+#include "GameHistoryStoreTest.moc"
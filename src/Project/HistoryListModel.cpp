@@ -0,0 +1,193 @@
+#include "HistoryListModel.h"
+#include <QCoreApplication>
+#include <QPointer>
+
+HistoryListModel::HistoryListModel(const GameHistoryStore* store, PersistenceWriter* writer,
+                                   const QString& player,
+                                   const QVector<GameHistoryStore::GameRef>& refs,
+                                   QObject* parent)
+    : QAbstractListModel(parent), store(store), writer(writer), player(player), refs(refs),
+      fetched(0), filterGeneration(0)
+{
+    setFilter(AllResults, AllModes);
+}
+
+int HistoryListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : fetched;
+}
+
+bool HistoryListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && fetched < rows.size();
+}
+
+void HistoryListModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    int more = qMin(PAGE_SIZE, static_cast<int>(rows.size()) - fetched);
+    if (more <= 0) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), fetched, fetched + more - 1);
+    fetched += more;
+    endInsertRows();
+}
+
+// Filtering only looks at the index entries, so no game is read here
+void HistoryListModel::setFilter(ResultFilter result, ModeFilter mode)
+{
+    beginResetModel();
+    rows.clear();
+    for (int i = 0; i < refs.size(); ++i) {
+        const GameHistoryStore::GameRef& ref = refs[i];
+        bool resultMatches = result == AllResults || (result == Wins && ref.winner == 'X') ||
+                             (result == Losses && ref.winner == 'O') ||
+                             (result == Ties && ref.winner == 'T');
+        bool modeMatches = mode == AllModes || (mode == PvAIOnly) == ref.vsAI;
+        if (resultMatches && modeMatches) {
+            rows.append(i);
+        }
+    }
+    fetched = 0;
+    pages.clear();
+    pageOrder.clear();
+    pendingPages.clear();
+    ++filterGeneration;
+    endResetModel();
+}
+
+QVariant HistoryListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= fetched) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return describe(index.row());
+    }
+    if (role == Qt::UserRole) {
+        return refs[rows[index.row()]].id;
+    }
+    return QVariant();
+}
+
+GameRecord HistoryListModel::game(int row) const
+{
+    const GameRecord* game = record(row);
+    return game ? *game : GameRecord();
+}
+
+// Null while the row's page is still being read
+const GameRecord* HistoryListModel::record(int row) const
+{
+    int page = row / PAGE_SIZE;
+    auto it = pages.find(page);
+    if (it == pages.end()) {
+        requestPage(page);
+        return nullptr;
+    }
+    pageOrder.removeOne(page);
+    pageOrder.append(page);
+    return &it.value()[row % PAGE_SIZE];
+}
+
+// The read is queued behind any pending writes and its result posted back
+// to the GUI thread; a model closed in the meantime just drops it
+void HistoryListModel::requestPage(int page) const
+{
+    if (pendingPages.contains(page)) {
+        return;
+    }
+    pendingPages.insert(page);
+
+    int first = page * PAGE_SIZE;
+    int last = qMin(first + PAGE_SIZE, static_cast<int>(rows.size()));
+    QVector<GameHistoryStore::GameRef> wanted;
+    wanted.reserve(last - first);
+    for (int i = first; i < last; ++i) {
+        wanted.append(refs[rows[i]]);
+    }
+
+    const GameHistoryStore* source = store;
+    QString owner = player;
+    int generation = filterGeneration;
+    QPointer<HistoryListModel> model(const_cast<HistoryListModel*>(this));
+    writer->enqueue([source, owner, wanted, page, generation, model]() {
+        // Games that fail to read are skipped by the store; keep the rest
+        // lined up with their rows
+        QVector<GameRecord> loaded = source->loadGames(wanted);
+        QVector<GameRecord> records(wanted.size());
+        for (int i = 0, next = 0; i < wanted.size(); ++i) {
+            if (next < loaded.size() && loaded[next].id == wanted[i].id) {
+                records[i] = loaded[next++];
+            } else {
+                records[i].id = wanted[i].id;
+                records[i].player = owner;
+            }
+        }
+        QMetaObject::invokeMethod(qApp, [model, page, generation, records]() {
+            if (model) {
+                model->pageLoaded(page, generation, records);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HistoryListModel::pageLoaded(int page, int generation, const QVector<GameRecord>& records)
+{
+    if (generation != filterGeneration) {
+        return;
+    }
+    pendingPages.remove(page);
+    if (pages.size() >= MAX_PAGES) {
+        pages.remove(pageOrder.takeFirst());
+    }
+    pages.insert(page, records);
+    pageOrder.append(page);
+
+    int first = page * PAGE_SIZE;
+    int last = qMin(first + static_cast<int>(records.size()), fetched) - 1;
+    if (first <= last) {
+        emit dataChanged(index(first), index(last), {Qt::DisplayRole});
+    }
+}
+
+QString HistoryListModel::describe(int row) const
+{
+    const GameRecord* loaded = record(row);
+    if (!loaded) {
+        return QString("Game #%1 | Loading...").arg(rows[row] + 1);
+    }
+    const GameRecord& game = *loaded;
+    const QString& winner = game.winner;
+    const QString& mode = game.mode;
+    const QString& opponent = game.opponent;
+
+    QString resultText;
+    if (winner == "T") {
+        resultText = "🤝 Tie";
+    } else if (winner == "X") {
+        resultText = QString("🎉 %1 Won").arg(player);
+    } else {
+        if (mode == "PvAI") {
+            resultText = "🤖 AI Won";
+        } else {
+            resultText = QString("🎉 %1 Won").arg(opponent);
+        }
+    }
+
+    QString modeText = (mode == "PvP") ? "Player vs Player" : "Player vs AI";
+    if (game.boardSize != 3) {
+        modeText += QString(" | %1x%1 (%2 in a row)").arg(game.boardSize).arg(game.winLength);
+    }
+    // Numbered by position in the whole history, so a filter keeps the numbers
+    return QString("Game #%1 | %2 | %3 vs %4 | %5 moves | %6")
+        .arg(rows[row] + 1)
+        .arg(resultText)
+        .arg(player)
+        .arg(opponent)
+        .arg(game.moves.size())
+        .arg(modeText);
+}
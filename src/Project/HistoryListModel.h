@@ -0,0 +1,63 @@
+#ifndef HISTORYLISTMODEL_H
+#define HISTORYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include "GameHistoryStore.h"
+#include "PersistenceWriter.h"
+
+// One player's game history for a list view. Only the index entries are
+// held up front, copied from the store on the thread that writes it; games
+// are read from the log a page at a time on that same thread as rows are
+// shown, and only the most recently used pages stay in memory. Rows are
+// handed to the view in chunks through canFetchMore/fetchMore.
+class HistoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum ResultFilter { AllResults, Wins, Losses, Ties };
+    enum ModeFilter { AllModes, PvPOnly, PvAIOnly };
+
+    HistoryListModel(const GameHistoryStore* store, PersistenceWriter* writer,
+                     const QString& player, const QVector<GameHistoryStore::GameRef>& refs,
+                     QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void setFilter(ResultFilter result, ModeFilter mode);
+    int totalCount() const { return refs.size(); }
+    // False until the row's page has arrived from the writer thread
+    bool isLoaded(int row) const { return pages.contains(row / PAGE_SIZE); }
+    GameRecord game(int row) const;
+
+private:
+    static constexpr int PAGE_SIZE = 64;
+    static constexpr int MAX_PAGES = 8;
+
+    const GameRecord* record(int row) const;
+    void requestPage(int page) const;
+    void pageLoaded(int page, int generation, const QVector<GameRecord>& records);
+    QString describe(int row) const;
+
+    const GameHistoryStore* store;
+    PersistenceWriter* writer;
+    QString player;
+    QVector<GameHistoryStore::GameRef> refs;   // every game, oldest first
+    QVector<int> rows;                         // refs that pass the filter
+    int fetched;
+
+    // Pages of rows, keyed by row / PAGE_SIZE, most recently used last
+    mutable QHash<int, QVector<GameRecord>> pages;
+    mutable QList<int> pageOrder;
+    mutable QSet<int> pendingPages;
+    int filterGeneration;   // pages read under an older filter are dropped
+};
+
+#endif // HISTORYLISTMODEL_H
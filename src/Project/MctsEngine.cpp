@@ -0,0 +1,258 @@
+#include "MctsEngine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// UCT exploration constant (sqrt 2 for results in [0, 1])
+constexpr float EXPLORATION = 1.41421356f;
+}
+
+MctsEngine::MctsEngine(int nodeLimit)
+    : nodeLimit(nodeLimit), treeSize(0), treeWinLength(0), rootMoveCount(0),
+      playoutCount(0), reusedVisits(0)
+{
+}
+
+void MctsEngine::setNodeLimit(int limit)
+{
+    nodeLimit = std::max(limit, Board::MAX_CELLS + 1);
+    clear();
+}
+
+void MctsEngine::clear()
+{
+    nodes.clear();
+    spare.clear();
+    treeSize = 0;
+    treeWinLength = 0;
+    rootMoveCount = 0;
+}
+
+char MctsEngine::sideToMove(const Board& board)
+{
+    // X always opens, so the side to move follows from the stone count
+    return board.getMoveCount() % 2 == 0 ? 'X' : 'O';
+}
+
+std::vector<std::pair<std::pair<int, int>, int>> MctsEngine::search(
+    const Board& board, int playouts, std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>& cancel)
+{
+    playoutCount = 0;
+    reusedVisits = 0;
+
+    if (findRoot(board)) {
+        reusedVisits = nodes[0].visits;
+    } else {
+        nodes.clear();
+        char mover = sideToMove(board) == 'X' ? 'O' : 'X';
+        nodes.push_back(Node{board.getHash(), -1, -1, 0, 0, 0.0f, 0, 0, mover, ' '});
+        treeSize = board.getSize();
+        treeWinLength = board.getWinLength();
+        rootMoveCount = board.getMoveCount();
+    }
+
+    std::vector<std::pair<std::pair<int, int>, int>> scored;
+    if (board.checkWin('X') || board.checkWin('O') || board.checkTie()) {
+        return scored;
+    }
+
+    Board work = board;
+    if (nodes[0].firstChild < 0) {
+        expand(0, work);
+    }
+
+    int path[Board::MAX_CELLS + 1];
+    for (; playoutCount < playouts; ++playoutCount) {
+        // Reading the clock is comparatively slow, so only look every 64 playouts
+        if ((playoutCount & 63) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        if (cancel.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        // Selection: follow UCT down to a leaf
+        int length = 0;
+        int index = 0;
+        path[length++] = index;
+        while (nodes[index].winner == ' ' && nodes[index].firstChild >= 0) {
+            index = selectChild(index);
+            work.makeMove(nodes[index].row, nodes[index].col, nodes[index].player);
+            path[length++] = index;
+        }
+
+        // Expansion: a leaf grows its children the second time it is reached
+        if (nodes[index].winner == ' ' && nodes[index].visits > 0) {
+            expand(index, work);
+            if (nodes[index].firstChild >= 0) {
+                index = selectChild(index);
+                work.makeMove(nodes[index].row, nodes[index].col, nodes[index].player);
+                path[length++] = index;
+            }
+        }
+
+        // Simulation
+        char winner = nodes[index].winner != ' ' ? nodes[index].winner : playout(work);
+
+        // Backpropagation
+        for (int i = length - 1; i >= 0; --i) {
+            Node& node = nodes[path[i]];
+            ++node.visits;
+            if (winner == node.player) {
+                node.wins += 1.0f;
+            } else if (winner == 'T') {
+                node.wins += 0.5f;
+            }
+            if (i > 0) {
+                work.undoMove(node.row, node.col);
+            }
+        }
+    }
+
+    const Node& root = nodes[0];
+    for (int i = 0; i < root.childCount; ++i) {
+        const Node& child = nodes[root.firstChild + i];
+        scored.push_back({{child.row, child.col}, child.visits});
+    }
+    return scored;
+}
+
+// Looks for the searched position among the previous root and the two plies
+// below it, and makes it the new root if found
+bool MctsEngine::findRoot(const Board& board)
+{
+    if (nodes.empty() || board.getSize() != treeSize ||
+        board.getWinLength() != treeWinLength) {
+        return false;
+    }
+
+    int plies = board.getMoveCount() - rootMoveCount;
+    if (plies < 0 || plies > 2) {
+        return false;
+    }
+
+    std::vector<int> level = {0};
+    for (int ply = 0; ply < plies; ++ply) {
+        std::vector<int> next;
+        for (int index : level) {
+            for (int i = 0; i < nodes[index].childCount; ++i) {
+                next.push_back(nodes[index].firstChild + i);
+            }
+        }
+        level.swap(next);
+    }
+
+    for (int index : level) {
+        if (nodes[index].hash == board.getHash()) {
+            if (index != 0) {
+                reroot(index);
+            }
+            rootMoveCount = board.getMoveCount();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Copies the subtree under newRoot to the front of the spare arena in
+// breadth-first order, which keeps every child block contiguous
+void MctsEngine::reroot(int newRoot)
+{
+    spare.clear();
+    spare.push_back(nodes[newRoot]);
+    spare[0].parent = -1;
+    for (size_t i = 0; i < spare.size(); ++i) {
+        int oldFirst = spare[i].firstChild;
+        if (oldFirst < 0) {
+            continue;
+        }
+        spare[i].firstChild = static_cast<int>(spare.size());
+        for (int c = 0; c < spare[i].childCount; ++c) {
+            spare.push_back(nodes[oldFirst + c]);
+            spare.back().parent = static_cast<int>(i);
+        }
+    }
+    nodes.swap(spare);
+}
+
+void MctsEngine::expand(int index, Board& board)
+{
+    MoveList moves;
+    board.generateCandidateMoves(moves);
+    if (index == 0) {
+        board.removeSymmetricMoves(moves);
+    }
+
+    // A full arena stops growing and keeps playing out from its leaves; the
+    // root is always expanded so there is something to choose from
+    if (index != 0 && static_cast<int>(nodes.size()) + moves.size() > nodeLimit) {
+        return;
+    }
+
+    char player = nodes[index].player == 'X' ? 'O' : 'X';
+    int first = static_cast<int>(nodes.size());
+    for (const Move& move : moves) {
+        board.makeMove(move.row, move.col, player);
+        char winner = board.checkWin(player) ? player : (board.checkTie() ? 'T' : ' ');
+        nodes.push_back(Node{board.getHash(), index, -1, 0, 0, 0.0f,
+                             static_cast<uint8_t>(move.row), static_cast<uint8_t>(move.col),
+                             player, winner});
+        board.undoMove(move.row, move.col);
+    }
+    nodes[index].firstChild = first;
+    nodes[index].childCount = moves.size();
+}
+
+int MctsEngine::selectChild(int index) const
+{
+    const Node& parent = nodes[index];
+    float logVisits = std::log(static_cast<float>(std::max(parent.visits, 1)));
+    int best = parent.firstChild;
+    float bestValue = -1.0f;
+
+    for (int i = 0; i < parent.childCount; ++i) {
+        int childIndex = parent.firstChild + i;
+        const Node& child = nodes[childIndex];
+        if (child.visits == 0) {
+            return childIndex;
+        }
+        float value = child.wins / child.visits +
+                      EXPLORATION * std::sqrt(logVisits / child.visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = childIndex;
+        }
+    }
+    return best;
+}
+
+// Plays uniformly random moves to the end of the game, then takes them all
+// back. Returns the winner, or 'T' for a tie.
+char MctsEngine::playout(Board& board)
+{
+    MoveList empty;
+    board.generateMoves(empty);
+    MoveList played;
+    char toMove = sideToMove(board);
+    char winner = 'T';
+
+    int remaining = empty.size();
+    while (remaining > 0) {
+        int pick = static_cast<int>(rng.below(remaining));
+        Move move = empty[pick];
+        empty[pick] = empty[--remaining];
+        board.makeMove(move.row, move.col, toMove);
+        played.push(move.row, move.col);
+        if (board.checkWin(toMove)) {
+            winner = toMove;
+            break;
+        }
+        toMove = toMove == 'X' ? 'O' : 'X';
+    }
+
+    for (const Move& move : played) {
+        board.undoMove(move.row, move.col);
+    }
+    return winner;
+}
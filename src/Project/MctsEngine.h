@@ -0,0 +1,71 @@
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Board.h"
+#include "Random.h"
+
+// Monte Carlo tree search (UCT) with random playouts. Nodes live in one
+// arena vector and the tree is kept between calls, so the subtree under the
+// position actually reached is reused for the next move.
+class MctsEngine
+{
+public:
+    static constexpr int DEFAULT_NODE_LIMIT = 1 << 19;   // 512k nodes
+
+    explicit MctsEngine(int nodeLimit = DEFAULT_NODE_LIMIT);
+
+    // Runs up to `playouts` simulations for the side to move, stopping early
+    // at the deadline or when `cancel` is set. Returns every root move with
+    // its visit count; the most visited move is the engine's choice.
+    std::vector<std::pair<std::pair<int, int>, int>> search(
+        const Board& board, int playouts, std::chrono::steady_clock::time_point deadline,
+        const std::atomic<bool>& cancel);
+
+    void setNodeLimit(int limit);
+    int getNodeLimit() const { return nodeLimit; }
+    void clear();
+    void setSeed(uint64_t seed) { rng.seed(seed); }
+
+    // Simulations run by the last search, and how many of the tree's
+    // visits were carried over from earlier searches
+    long long getLastPlayoutCount() const { return playoutCount; }
+    int getLastReusedVisits() const { return reusedVisits; }
+
+private:
+    struct Node {
+        uint64_t hash;
+        int parent;
+        int firstChild;   // children are contiguous in the arena; -1 until expanded
+        int childCount;
+        int visits;
+        float wins;       // from the view of the side that moved into this node
+        uint8_t row;
+        uint8_t col;
+        char player;      // side that moved into this node
+        char winner;      // 'X', 'O', 'T' for a tie, ' ' while undecided
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Node> spare;   // second arena used while re-rooting
+    int nodeLimit;
+    int treeSize;
+    int treeWinLength;
+    int rootMoveCount;
+    long long playoutCount;
+    int reusedVisits;
+    Random rng;
+
+    bool findRoot(const Board& board);
+    void reroot(int newRoot);
+    void expand(int index, Board& board);
+    int selectChild(int index) const;
+    char playout(Board& board);
+    static char sideToMove(const Board& board);
+};
+
+#endif // MCTSENGINE_H
@@ -0,0 +1,98 @@
+#include "MoveSequence.h"
+
+MoveSequence::MoveSequence(int boardSize)
+    : boardSize(boardSize), count(0)
+{
+}
+
+void MoveSequence::clear()
+{
+    count = 0;
+    bytes.clear();
+}
+
+void MoveSequence::append(int row, int col)
+{
+    unsigned cell = static_cast<unsigned>(row * boardSize + col);
+    if (isPacked()) {
+        // Even moves take the low nibble of a new byte, odd moves the high one
+        if (count % 2 == 0) {
+            bytes.push_back(static_cast<uint8_t>(cell));
+        } else {
+            bytes.back() |= static_cast<uint8_t>(cell << 4);
+        }
+    } else {
+        while (cell >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(cell | 0x80));
+            cell >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(cell));
+    }
+    ++count;
+}
+
+Move MoveSequence::at(int index) const
+{
+    unsigned cell = 0;
+    if (isPacked()) {
+        cell = (bytes[index / 2] >> (index % 2 * 4)) & 0x0F;
+    } else {
+        size_t offset = 0;
+        for (int i = 0; i <= index; ++i) {
+            cell = 0;
+            for (int shift = 0;; shift += 7) {
+                uint8_t byte = bytes[offset++];
+                cell |= static_cast<unsigned>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+        }
+    }
+    return Move{static_cast<int>(cell) / boardSize, static_cast<int>(cell) % boardSize};
+}
+
+bool MoveSequence::assign(int size, int moves, const uint8_t* data, size_t length)
+{
+    boardSize = size;
+    clear();
+    if (size < Board::MIN_SIZE || size > Board::MAX_SIZE || moves < 0 ||
+        moves > size * size) {
+        return false;
+    }
+
+    // Decode into a fresh sequence so only well-formed input is kept
+    unsigned cells = static_cast<unsigned>(size * size);
+    size_t offset = 0;
+    MoveSequence decoded(size);
+    for (int i = 0; i < moves; ++i) {
+        unsigned cell = 0;
+        if (isPacked()) {
+            if (static_cast<size_t>(i / 2) >= length) {
+                return false;
+            }
+            cell = (data[i / 2] >> (i % 2 * 4)) & 0x0F;
+            offset = static_cast<size_t>(i / 2) + 1;
+        } else {
+            for (int shift = 0;; shift += 7) {
+                if (offset >= length || shift > 14) {
+                    return false;
+                }
+                uint8_t byte = data[offset++];
+                cell |= static_cast<unsigned>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+        }
+        if (cell >= cells) {
+            return false;
+        }
+        decoded.append(static_cast<int>(cell) / size, static_cast<int>(cell) % size);
+    }
+    if (offset != length) {
+        return false;
+    }
+    *this = decoded;
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef MOVESEQUENCE_H
+#define MOVESEQUENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+// The moves of one game in compact form. X always moves first and the
+// players alternate, so only cells are kept: two moves per byte (4 bits
+// each) on 3x3, and one varint cell index per move on larger boards. The
+// same bytes are used in memory, in the history log and for replay.
+class MoveSequence
+{
+public:
+    explicit MoveSequence(int boardSize = 3);
+
+    int getBoardSize() const { return boardSize; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear();
+    void append(int row, int col);
+    // Sequential on larger boards, which is all replay needs
+    Move at(int index) const;
+    static char playerAt(int index) { return index % 2 == 0 ? 'X' : 'O'; }
+
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+    // Takes encoded bytes as written by getBytes(); false (and left empty)
+    // unless they hold exactly `moves` cells that fit the board
+    bool assign(int boardSize, int moves, const uint8_t* data, size_t length);
+
+private:
+    bool isPacked() const { return boardSize == 3; }
+
+    int boardSize;
+    int count;
+    std::vector<uint8_t> bytes;
+};
+
+#endif // MOVESEQUENCE_H
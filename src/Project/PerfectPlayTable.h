@@ -0,0 +1,204 @@
+#ifndef PERFECTPLAYTABLE_H
+#define PERFECTPLAYTABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "Board.h"
+#include "Symmetry.h"
+
+// Perfect-play table for the 3x3 board, solved by the compiler.
+// Every position reachable with X moving first is indexed by its base-3
+// encoding (empty = 0, X = 1, O = 2 per cell). Values follow
+// AIPlayer::minimax: a position searched at ply d scores (value - d),
+// with +10 / -10 / 0 for an O win, X win or tie. The search uses a larger
+// win score, which orders every position the same way. The values, and so
+// the best moves for X, are O's view: only an AI playing O can use them.
+// Only one position per rotation/reflection class is kept: the one with the
+// lowest index. Lookups map a position onto it and its best moves back.
+namespace PerfectPlay
+{
+constexpr int STATES = 19683; // 3^9
+
+struct Entry {
+    int8_t value = 0;
+    bool reachable = false;
+    uint16_t bestMoves = 0; // optimal cells for the side to move
+};
+
+constexpr int popcount(uint16_t mask)
+{
+    int count = 0;
+    for (; mask; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+constexpr std::array<int, 512> makeTernaryTable()
+{
+    std::array<int, 512> table{};
+    for (int mask = 0; mask < 512; ++mask) {
+        int value = 0;
+        int power = 1;
+        for (int cell = 0; cell < 9; ++cell) {
+            if (mask & (1 << cell)) {
+                value += power;
+            }
+            power *= 3;
+        }
+        table[mask] = value;
+    }
+    return table;
+}
+
+inline constexpr std::array<int, 512> TERNARY = makeTernaryTable();
+
+constexpr int stateIndex(uint16_t xMask, uint16_t oMask)
+{
+    return TERNARY[xMask] + 2 * TERNARY[oMask];
+}
+
+constexpr int solve(std::array<Entry, STATES>& table, uint16_t xMask, uint16_t oMask)
+{
+    Entry& entry = table[stateIndex(xMask, oMask)];
+    if (entry.reachable) {
+        return entry.value;
+    }
+    entry.reachable = true;
+
+    if (Board::isWinningMask(oMask)) {
+        entry.value = 10;
+        return entry.value;
+    }
+    if (Board::isWinningMask(xMask)) {
+        entry.value = -10;
+        return entry.value;
+    }
+    if ((xMask | oMask) == Board::FULL_MASK) {
+        entry.value = 0;
+        return entry.value;
+    }
+
+    bool oToMove = popcount(xMask) > popcount(oMask);
+    int best = oToMove ? -128 : 127;
+    uint16_t bestMoves = 0;
+
+    for (int cell = 0; cell < 9; ++cell) {
+        uint16_t bit = static_cast<uint16_t>(1u << cell);
+        if ((xMask | oMask) & bit) {
+            continue;
+        }
+        int score = oToMove ? solve(table, xMask, oMask | bit)
+                            : solve(table, xMask | bit, oMask);
+        if (score == best) {
+            bestMoves |= bit;
+        } else if (oToMove ? score > best : score < best) {
+            best = score;
+            bestMoves = bit;
+        }
+    }
+
+    entry.value = static_cast<int8_t>(best - 1);
+    entry.bestMoves = bestMoves;
+    return entry.value;
+}
+
+constexpr std::array<Entry, STATES> solveAll()
+{
+    std::array<Entry, STATES> table{};
+    solve(table, 0, 0);
+    return table;
+}
+
+// Full solution; only used while building CLASS_TABLE
+inline constexpr std::array<Entry, STATES> SOLVED = solveAll();
+
+struct ClassEntry {
+    uint16_t state = 0;     // lowest index among the symmetric positions
+    int8_t value = 0;
+    uint16_t bestMoves = 0;
+};
+
+constexpr int lowestSymmetricIndex(uint16_t xMask, uint16_t oMask, int& symmetry)
+{
+    int lowest = stateIndex(xMask, oMask);
+    symmetry = 0;
+    for (int sym = 1; sym < Symmetry::COUNT; ++sym) {
+        int index = stateIndex(Symmetry::transformMask(xMask, sym),
+                               Symmetry::transformMask(oMask, sym));
+        if (index < lowest) {
+            lowest = index;
+            symmetry = sym;
+        }
+    }
+    return lowest;
+}
+
+constexpr bool isClassRepresentative(int state)
+{
+    if (!SOLVED[state].reachable) {
+        return false;
+    }
+    uint16_t xMask = 0;
+    uint16_t oMask = 0;
+    for (int cell = 0, rest = state; cell < 9; ++cell, rest /= 3) {
+        if (rest % 3 == 1) {
+            xMask |= static_cast<uint16_t>(1u << cell);
+        } else if (rest % 3 == 2) {
+            oMask |= static_cast<uint16_t>(1u << cell);
+        }
+    }
+    int symmetry = 0;
+    return lowestSymmetricIndex(xMask, oMask, symmetry) == state;
+}
+
+constexpr int countClasses()
+{
+    int count = 0;
+    for (int state = 0; state < STATES; ++state) {
+        if (isClassRepresentative(state)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+constexpr int CLASSES = countClasses();
+
+// Sorted by state, so lookups can binary search
+constexpr std::array<ClassEntry, CLASSES> makeClassTable()
+{
+    std::array<ClassEntry, CLASSES> table{};
+    int next = 0;
+    for (int state = 0; state < STATES; ++state) {
+        if (isClassRepresentative(state)) {
+            table[next].state = static_cast<uint16_t>(state);
+            table[next].value = SOLVED[state].value;
+            table[next].bestMoves = SOLVED[state].bestMoves;
+            ++next;
+        }
+    }
+    return table;
+}
+
+inline constexpr std::array<ClassEntry, CLASSES> CLASS_TABLE = makeClassTable();
+
+inline Entry lookup(uint16_t xMask, uint16_t oMask)
+{
+    int symmetry = 0;
+    int state = lowestSymmetricIndex(xMask, oMask, symmetry);
+    auto found = std::lower_bound(CLASS_TABLE.begin(), CLASS_TABLE.end(), state,
+                                  [](const ClassEntry& entry, int key) { return entry.state < key; });
+
+    Entry entry;
+    if (found != CLASS_TABLE.end() && found->state == state) {
+        entry.reachable = true;
+        entry.value = found->value;
+        entry.bestMoves = Symmetry::transformMask(found->bestMoves, Symmetry::inverse(symmetry));
+    }
+    return entry;
+}
+}
+
+#endif // PERFECTPLAYTABLE_H
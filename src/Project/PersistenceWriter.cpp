@@ -0,0 +1,77 @@
+#include "PersistenceWriter.h"
+#include <algorithm>
+
+PersistenceWriter::PersistenceWriter(int capacity)
+    : capacity(static_cast<size_t>(std::max(1, capacity))), busy(false), stopping(false),
+      worker(&PersistenceWriter::workerLoop, this)
+{
+}
+
+PersistenceWriter::~PersistenceWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void PersistenceWriter::enqueue(Job job, const QString& key)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!key.isEmpty()) {
+        auto queued = std::find_if(queue.begin(), queue.end(),
+                                   [&key](const Entry& entry) { return entry.key == key; });
+        // The replacement moves to the tail, so it still runs after every
+        // job queued before it and the queue does not grow
+        if (queued != queue.end()) {
+            queue.erase(queued);
+            queue.push_back({key, std::move(job)});
+            return;
+        }
+    }
+
+    space.wait(lock, [this]() { return queue.size() < capacity; });
+    queue.push_back({key, std::move(job)});
+    lock.unlock();
+    wake.notify_one();
+}
+
+void PersistenceWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return queue.empty() && !busy; });
+}
+
+// The queue is only left once it is empty, so stopping still writes out
+// everything queued before the destructor ran
+void PersistenceWriter::workerLoop()
+{
+    for (;;) {
+        std::deque<Entry> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            batch.swap(queue);
+            busy = true;
+        }
+        space.notify_all();
+
+        for (Entry& entry : batch) {
+            entry.job();
+        }
+        if (batchFinished) {
+            batchFinished();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+        }
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef PERSISTENCEWRITER_H
+#define PERSISTENCEWRITER_H
+
+#include <QString>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs file writes on one background thread so disk latency never reaches
+// the GUI thread. Jobs run in the order they were queued. Everything queued
+// while the thread is busy runs as one batch, followed by a single call to
+// the batch hook (typically one fsync for the whole batch).
+class PersistenceWriter
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit PersistenceWriter(int capacity = 256);
+    // Writes everything still queued before returning
+    ~PersistenceWriter();
+
+    // Must be set before the first job is queued
+    void setBatchFinished(Job hook) { batchFinished = std::move(hook); }
+
+    // Blocks only while `capacity` jobs are already waiting. A job with a key
+    // drops a queued job with the same key that has not started and joins the
+    // end of the queue, so rapid snapshots of the same file collapse into one
+    // write that still runs after everything queued before it.
+    void enqueue(Job job, const QString& key = QString());
+
+    // Waits until every queued job has run; afterwards the caller may read
+    // what the jobs wrote
+    void flush();
+
+private:
+    struct Entry {
+        QString key;
+        Job job;
+    };
+
+    void workerLoop();
+
+    std::deque<Entry> queue;
+    Job batchFinished;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable space;
+    std::condition_variable idle;
+    size_t capacity;
+    bool busy;
+    bool stopping;
+    std::thread worker;
+};
+
+#endif // PERSISTENCEWRITER_H
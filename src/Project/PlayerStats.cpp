@@ -0,0 +1,70 @@
+#include "PlayerStats.h"
+#include "GameHistoryStore.h"
+
+void ResultCounts::add(const QString& winner)
+{
+    if (winner == "X") {
+        ++wins;
+    } else if (winner == "O") {
+        ++losses;
+    } else {
+        ++ties;
+    }
+}
+
+void PlayerStats::addGame(const GameRecord& game)
+{
+    overall.add(game.winner);
+    byMode[game.mode].add(game.winner);
+    byOpponent[game.opponent].add(game.winner);
+    if (!game.difficulty.isEmpty()) {
+        byDifficulty[game.difficulty].add(game.winner);
+    }
+    totalMoves += game.moves.size();
+
+    // A tie ends either kind of streak
+    if (game.winner == "X") {
+        currentStreak = currentStreak > 0 ? currentStreak + 1 : 1;
+        longestWinStreak = qMax(longestWinStreak, currentStreak);
+    } else if (game.winner == "O") {
+        currentStreak = currentStreak < 0 ? currentStreak - 1 : -1;
+    } else {
+        currentStreak = 0;
+    }
+}
+
+double PlayerStats::averageLength() const
+{
+    return overall.total() > 0 ? double(totalMoves) / overall.total() : 0.0;
+}
+
+QDataStream& operator<<(QDataStream& out, const ResultCounts& counts)
+{
+    return out << qint32(counts.wins) << qint32(counts.losses) << qint32(counts.ties);
+}
+
+QDataStream& operator>>(QDataStream& in, ResultCounts& counts)
+{
+    qint32 wins = 0, losses = 0, ties = 0;
+    in >> wins >> losses >> ties;
+    counts.wins = wins;
+    counts.losses = losses;
+    counts.ties = ties;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const PlayerStats& stats)
+{
+    return out << stats.overall << stats.byMode << stats.byOpponent << stats.byDifficulty
+               << qint32(stats.currentStreak) << qint32(stats.longestWinStreak) << stats.totalMoves;
+}
+
+QDataStream& operator>>(QDataStream& in, PlayerStats& stats)
+{
+    qint32 currentStreak = 0, longestWinStreak = 0;
+    in >> stats.overall >> stats.byMode >> stats.byOpponent >> stats.byDifficulty
+       >> currentStreak >> longestWinStreak >> stats.totalMoves;
+    stats.currentStreak = currentStreak;
+    stats.longestWinStreak = longestWinStreak;
+    return in;
+}
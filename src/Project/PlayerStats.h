@@ -0,0 +1,40 @@
+#ifndef PLAYERSTATS_H
+#define PLAYERSTATS_H
+
+#include <QString>
+#include <QHash>
+#include <QDataStream>
+
+struct GameRecord;
+
+// Wins, losses and ties from the logged-in player's (X's) side
+struct ResultCounts {
+    int wins = 0;
+    int losses = 0;
+    int ties = 0;
+
+    int total() const { return wins + losses + ties; }
+    void add(const QString& winner);
+};
+
+// Running totals over one player's games, updated as each game is saved so
+// reading them never walks the history
+struct PlayerStats {
+    ResultCounts overall;
+    QHash<QString, ResultCounts> byMode;
+    QHash<QString, ResultCounts> byOpponent;
+    QHash<QString, ResultCounts> byDifficulty;   // PvAI games only
+    int currentStreak = 0;      // > 0 wins in a row, < 0 losses in a row
+    int longestWinStreak = 0;
+    qint64 totalMoves = 0;
+
+    void addGame(const GameRecord& game);
+    double averageLength() const;
+};
+
+QDataStream& operator<<(QDataStream& out, const ResultCounts& counts);
+QDataStream& operator>>(QDataStream& in, ResultCounts& counts);
+QDataStream& operator<<(QDataStream& out, const PlayerStats& stats);
+QDataStream& operator>>(QDataStream& in, PlayerStats& stats);
+
+#endif // PLAYERSTATS_H
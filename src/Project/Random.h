@@ -0,0 +1,71 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include "Zobrist.h"
+
+// xoshiro256** generator. A few shifts and rotates per number, 32 bytes of
+// state, and the same sequence on every compiler and standard library for a
+// given seed, so AI decisions can be replayed exactly. Not thread-safe:
+// every AIPlayer and MctsEngine owns its own.
+class Random
+{
+public:
+    using result_type = uint64_t;
+
+    explicit Random(uint64_t seed = randomSeed()) { this->seed(seed); }
+
+    // The four state words are expanded from the seed with splitmix64, which
+    // never leaves them all zero
+    void seed(uint64_t value)
+    {
+        seedValue = value;
+        for (uint64_t& word : state) {
+            word = Zobrist::splitmix64(value);
+        }
+    }
+
+    uint64_t getSeed() const { return seedValue; }
+
+    uint64_t operator()()
+    {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound) for 0 < bound < 2^32, by multiply and shift
+    // instead of a division; the bias is below 2^-32
+    uint32_t below(uint32_t bound)
+    {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // True with the given chance in percent
+    bool percent(int chance) { return below(100) < static_cast<uint32_t>(chance); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    static uint64_t randomSeed()
+    {
+        std::random_device device;
+        return (uint64_t(device()) << 32) ^ device();
+    }
+
+private:
+    uint64_t state[4];
+    uint64_t seedValue;
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // RANDOM_H
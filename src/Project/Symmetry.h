@@ -0,0 +1,71 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <array>
+#include <cstdint>
+
+// The 8 rotations and reflections of a square board, as compile-time cell
+// permutation tables. Every transform maps k-in-a-row lines onto lines, so
+// symmetric positions have the same value on any board size.
+namespace Symmetry
+{
+constexpr int COUNT = 8;
+constexpr int MAX_SIZE = 16; // Board::MAX_SIZE
+constexpr int CELLS = MAX_SIZE * MAX_SIZE;
+
+using Permutation = std::array<uint8_t, CELLS>;
+
+// 0 identity, 1-3 rotations by 90/180/270 degrees, 4 mirror left-right,
+// 5 transpose, 6 mirror top-bottom, 7 anti-transpose
+constexpr int transformCell(int sym, int size, int row, int col)
+{
+    int last = size - 1;
+    switch (sym) {
+    case 1: return col * size + (last - row);
+    case 2: return (last - row) * size + (last - col);
+    case 3: return (last - col) * size + row;
+    case 4: return row * size + (last - col);
+    case 5: return col * size + row;
+    case 6: return (last - row) * size + col;
+    case 7: return (last - col) * size + (last - row);
+    default: return row * size + col;
+    }
+}
+
+constexpr int inverse(int sym)
+{
+    return sym == 1 ? 3 : (sym == 3 ? 1 : sym);
+}
+
+constexpr std::array<std::array<Permutation, COUNT>, MAX_SIZE + 1> makePermutations()
+{
+    std::array<std::array<Permutation, COUNT>, MAX_SIZE + 1> tables{};
+    for (int size = 1; size <= MAX_SIZE; ++size) {
+        for (int sym = 0; sym < COUNT; ++sym) {
+            for (int cell = 0; cell < size * size; ++cell) {
+                tables[size][sym][cell] =
+                    static_cast<uint8_t>(transformCell(sym, size, cell / size, cell % size));
+            }
+        }
+    }
+    return tables;
+}
+
+// PERMUTATIONS[size][sym][cell] is where `cell` lands under `sym`
+inline constexpr std::array<std::array<Permutation, COUNT>, MAX_SIZE + 1> PERMUTATIONS =
+    makePermutations();
+
+// Applies a symmetry to a classic 3x3 mask (bit i is cell (i / 3, i % 3))
+constexpr uint16_t transformMask(uint16_t mask, int sym)
+{
+    uint16_t result = 0;
+    for (int cell = 0; cell < 9; ++cell) {
+        if (mask & (1u << cell)) {
+            result |= static_cast<uint16_t>(1u << PERMUTATIONS[3][sym][cell]);
+        }
+    }
+    return result;
+}
+}
+
+#endif // SYMMETRY_H
@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads)
+    : currentTask(nullptr), generation(0), pending(0), stopping(false)
+{
+    resize(threads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopWorkers();
+}
+
+void ThreadPool::resize(int threads)
+{
+    threads = std::max(1, threads);
+    if (threads == size()) {
+        return;
+    }
+
+    stopWorkers();
+    stopping = false;
+    for (int worker = 1; worker < threads; ++worker) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker, generation);
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        pending = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return pending == 0; });
+    currentTask = nullptr;
+}
+
+// seen starts at the generation current when the worker was created, so a
+// run() that begins before the thread first waits is still picked up
+void ThreadPool::workerLoop(int worker, unsigned long long seen)
+{
+    for (;;) {
+        const std::function<void(int)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = currentTask;
+        }
+
+        (*task)(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    workers.clear();
+}
@@ -0,0 +1,39 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of search threads that run one task on every worker at a time.
+// Worker 0 is the calling thread, so a pool of size 1 starts no threads.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads = 1);
+    ~ThreadPool();
+
+    // Not safe to call while run() is in progress
+    void resize(int threads);
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    // Calls task(worker) for every worker and returns once all have finished
+    void run(const std::function<void(int)>& task);
+
+private:
+    void workerLoop(int worker, unsigned long long seen);
+    void stopWorkers();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(int)>* currentTask;
+    unsigned long long generation;
+    int pending;
+    bool stopping;
+};
+
+#endif // THREADPOOL_H
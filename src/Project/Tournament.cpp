@@ -0,0 +1,307 @@
+// Headless self-play tournament. Every pair of the given players plays
+// --games games, spread over --threads workers with the sides alternating,
+// and each pairing reports win/draw/loss rates for its first player with
+// 95% Wilson confidence intervals, overall and per side.
+//
+//   TicTacToeTournament [--games=N] [--threads=N] [--seed=N] [--size=N]
+//                       [--win=N] [--time-limit=ms] [PLAYER...]
+//
+// A player is EASY, MEDIUM or HARD, optionally prefixed MCTS- to use the
+// MCTS engine. Without players every pair of EASY, MEDIUM and HARD plays.
+// Each worker keeps its players, and their tables, across games as the GUI
+// does, and plays a fixed share of the games with per-game seeds, so without
+// a time limit a run repeats exactly for the same seed and thread count.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Board.h"
+#include "AIPlayer.h"
+#include "Zobrist.h"
+
+namespace {
+struct Options {
+    long long games = 10000;
+    int threads = 0;                // 0 = one per core
+    uint64_t seed = 1;
+    int size = 3;
+    int winLength = 3;
+    int timeLimitMs = -1;           // -1 = none on 3x3, 100 ms otherwise
+};
+
+struct PlayerSpec {
+    std::string name;
+    AIPlayer::Difficulty difficulty;
+    AIPlayer::Engine engine;
+};
+
+// Outcomes for the pairing's first player, by the side it played
+struct Results {
+    enum Outcome { WIN, DRAW, LOSS };
+    long long counts[2][3] = {};    // [0 = as X, 1 = as O][outcome]
+    long long forfeits = 0;         // games where an engine returned no move
+
+    void merge(const Results& other)
+    {
+        for (int side = 0; side < 2; ++side) {
+            for (int outcome = 0; outcome < 3; ++outcome) {
+                counts[side][outcome] += other.counts[side][outcome];
+            }
+        }
+        forfeits += other.forfeits;
+    }
+};
+
+// Workers take every threadCount-th chunk of games
+constexpr long long CHUNK = 64;
+
+bool parsePlayer(const char* text, PlayerSpec& spec)
+{
+    std::string name = text;
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    spec.name = name;
+    spec.engine = AIPlayer::MINIMAX;
+    if (name.compare(0, 5, "MCTS-") == 0) {
+        spec.engine = AIPlayer::MCTS;
+        name = name.substr(5);
+    }
+
+    if (name == "EASY") {
+        spec.difficulty = AIPlayer::EASY;
+    } else if (name == "MEDIUM") {
+        spec.difficulty = AIPlayer::MEDIUM;
+    } else if (name == "HARD") {
+        spec.difficulty = AIPlayer::HARD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void configure(AIPlayer& ai, const PlayerSpec& spec, const Options& options)
+{
+    ai.setDifficulty(spec.difficulty);
+    ai.setEngine(spec.engine);
+    ai.setThreadCount(1);
+    ai.setTimeLimit(options.timeLimitMs);
+}
+
+// Plays one game and returns the winning mark, 'T' for a tie or '?' when the
+// side to move had no move to give
+char playGame(Board& board, AIPlayer& xPlayer, AIPlayer& oPlayer)
+{
+    board.reset();
+    xPlayer.setSide('X');
+    oPlayer.setSide('O');
+
+    for (int turn = 0;; ++turn) {
+        char mark = turn % 2 == 0 ? 'X' : 'O';
+        AIPlayer& mover = turn % 2 == 0 ? xPlayer : oPlayer;
+        std::pair<int, int> move = mover.getMove(&board);
+        if (move.first < 0 || !board.makeMove(move.first, move.second, mark)) {
+            return '?';
+        }
+        if (board.checkWin(mark)) {
+            return mark;
+        }
+        if (board.checkTie()) {
+            return 'T';
+        }
+    }
+}
+
+// The seed for one player in one game depends only on the run seed, the
+// pairing and the game number
+uint64_t gameSeed(uint64_t seed, int pairing, long long game, int player)
+{
+    uint64_t state = seed ^ (uint64_t(pairing) << 48) ^ (uint64_t(game) << 1) ^ uint64_t(player);
+    return Zobrist::splitmix64(state);
+}
+
+Results runPairing(const Options& options, int pairing, const PlayerSpec& first,
+                   const PlayerSpec& second, int threadCount)
+{
+    std::vector<Results> workerResults(threadCount);
+    std::vector<std::thread> workers;
+
+    for (int worker = 0; worker < threadCount; ++worker) {
+        workers.emplace_back([&, worker]() {
+            AIPlayer a;
+            AIPlayer b;
+            configure(a, first, options);
+            configure(b, second, options);
+            Board board(options.size, options.winLength);
+            Results& results = workerResults[worker];
+
+            for (long long start = worker * CHUNK; start < options.games;
+                 start += threadCount * CHUNK) {
+                long long end = std::min(start + CHUNK, options.games);
+                for (long long game = start; game < end; ++game) {
+                    a.setSeed(gameSeed(options.seed, pairing, game, 0));
+                    b.setSeed(gameSeed(options.seed, pairing, game, 1));
+
+                    // The first player opens the even games
+                    int side = game % 2 == 0 ? 0 : 1;
+                    char firstMark = side == 0 ? 'X' : 'O';
+                    char winner = side == 0 ? playGame(board, a, b) : playGame(board, b, a);
+
+                    if (winner == '?') {
+                        ++results.forfeits;
+                    } else if (winner == 'T') {
+                        ++results.counts[side][Results::DRAW];
+                    } else if (winner == firstMark) {
+                        ++results.counts[side][Results::WIN];
+                    } else {
+                        ++results.counts[side][Results::LOSS];
+                    }
+                }
+            }
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    Results total;
+    for (const Results& results : workerResults) {
+        total.merge(results);
+    }
+    return total;
+}
+
+// 95% Wilson score interval for `hits` out of `total`, in percent
+void wilson(long long hits, long long total, double& low, double& high)
+{
+    if (total == 0) {
+        low = high = 0.0;
+        return;
+    }
+    const double z = 1.959964;
+    double n = double(total);
+    double p = hits / n;
+    double denominator = 1.0 + z * z / n;
+    double center = (p + z * z / (2.0 * n)) / denominator;
+    double margin = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+    low = 100.0 * std::max(0.0, center - margin);
+    high = 100.0 * std::min(1.0, center + margin);
+}
+
+void printRow(const char* label, const long long counts[3])
+{
+    long long total = counts[0] + counts[1] + counts[2];
+    std::printf("  %-10s %10lld", label, total);
+    for (int outcome = 0; outcome < 3; ++outcome) {
+        double low = 0.0;
+        double high = 0.0;
+        wilson(counts[outcome], total, low, high);
+        double rate = total > 0 ? 100.0 * counts[outcome] / total : 0.0;
+        std::printf("   %6.2f%% [%6.2f, %6.2f]", rate, low, high);
+    }
+    std::printf("\n");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    std::vector<PlayerSpec> players;
+    for (int i = 1; i < argc; ++i) {
+        PlayerSpec spec;
+        if (std::strncmp(argv[i], "--games=", 8) == 0) {
+            options.games = std::max(1LL, std::atoll(argv[i] + 8));
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.threads = std::max(0, std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--size=", 7) == 0) {
+            options.size = std::atoi(argv[i] + 7);
+        } else if (std::strncmp(argv[i], "--win=", 6) == 0) {
+            options.winLength = std::atoi(argv[i] + 6);
+        } else if (std::strncmp(argv[i], "--time-limit=", 13) == 0) {
+            options.timeLimitMs = std::max(0, std::atoi(argv[i] + 13));
+        } else if (argv[i][0] != '-' && parsePlayer(argv[i], spec)) {
+            players.push_back(spec);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--games=N] [--threads=N] [--seed=N] [--size=N] [--win=N]\n"
+                         "          [--time-limit=ms] [PLAYER...]\n"
+                         "PLAYER: EASY, MEDIUM, HARD, MCTS-EASY, MCTS-MEDIUM or MCTS-HARD\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (players.empty()) {
+        for (const char* name : {"EASY", "MEDIUM", "HARD"}) {
+            PlayerSpec spec;
+            parsePlayer(name, spec);
+            players.push_back(spec);
+        }
+    }
+    if (players.size() == 1) {
+        players.push_back(players.front());
+    }
+
+    // Board clamps the variant; report what is actually played
+    Board variant(options.size, options.winLength);
+    options.size = variant.getSize();
+    options.winLength = variant.getWinLength();
+    if (options.timeLimitMs < 0) {
+        options.timeLimitMs = variant.isClassic() ? 0 : 100;
+    }
+    int threadCount = options.threads > 0
+                          ? options.threads
+                          : std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("%dx%d, %d in a row, %lld games per pairing, %d threads, seed %llu, "
+                "time limit %d ms\n",
+                options.size, options.size, options.winLength, options.games, threadCount,
+                static_cast<unsigned long long>(options.seed), options.timeLimitMs);
+
+    using Clock = std::chrono::steady_clock;
+    long long totalGames = 0;
+    auto runStart = Clock::now();
+    int pairing = 0;
+
+    for (size_t i = 0; i < players.size(); ++i) {
+        for (size_t j = i + 1; j < players.size(); ++j, ++pairing) {
+            const PlayerSpec& first = players[i];
+            const PlayerSpec& second = players[j];
+
+            auto start = Clock::now();
+            Results results = runPairing(options, pairing, first, second, threadCount);
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            totalGames += options.games;
+
+            std::printf("\n%s vs %s: %.2f s, %.0f games/s\n", first.name.c_str(),
+                        second.name.c_str(), elapsed, options.games / elapsed);
+            std::printf("  %-10s %10s   %-24s   %-24s   %-24s\n", "side", "games",
+                        ("win " + first.name).c_str(), "draw", ("loss " + first.name).c_str());
+
+            long long overall[3];
+            for (int outcome = 0; outcome < 3; ++outcome) {
+                overall[outcome] = results.counts[0][outcome] + results.counts[1][outcome];
+            }
+            printRow("both", overall);
+            printRow("as X", results.counts[0]);
+            printRow("as O", results.counts[1]);
+            if (results.forfeits > 0) {
+                std::printf("  %lld games stopped without a move\n", results.forfeits);
+            }
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - runStart).count();
+    std::printf("\n%lld games in %.2f s, %.0f games/s\n", totalGames, elapsed,
+                totalGames / elapsed);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(int sizeLog2)
+    : slots(new Slot[size_t(1) << sizeLog2]), mask((size_t(1) << sizeLog2) - 1)
+{
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const
+{
+    const Slot& slot = slots[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key) {
+        return false;
+    }
+
+    entry.key = key;
+    entry.score = static_cast<int16_t>(data & 0xFFFF);
+    entry.draft = static_cast<int16_t>((data >> 16) & 0xFFFF);
+    entry.bound = static_cast<Bound>((data >> 32) & 0xFF);
+    return entry.bound != NONE;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int draft, Bound bound)
+{
+    uint64_t data = uint64_t(static_cast<uint16_t>(score)) |
+                    (uint64_t(static_cast<uint16_t>(draft)) << 16) |
+                    (uint64_t(bound) << 32);
+    Slot& slot = slots[key & mask];
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].data.store(0, std::memory_order_relaxed);
+        slots[i].check.store(0, std::memory_order_relaxed);
+    }
+}
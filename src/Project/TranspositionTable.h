@@ -0,0 +1,49 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Lock-free table shared by all search threads. Each slot stores the packed
+// entry and (key ^ entry); a slot torn by two concurrent writers fails the
+// key check on probe and reads as a miss.
+class TranspositionTable
+{
+public:
+    enum Bound : uint8_t {
+        NONE,
+        EXACT,
+        LOWER,
+        UPPER
+    };
+
+    struct Entry {
+        uint64_t key = 0;
+        int16_t score = 0;
+        int16_t draft = 0;
+        Bound bound = NONE;
+    };
+
+    // Draft stored for subtrees that were searched to the end of the game.
+    // Real drafts never reach it: a 16x16 board has only 256 plies.
+    static constexpr int FULL_DRAFT = 32767;
+
+    explicit TranspositionTable(int sizeLog2 = 16);
+
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, int score, int draft, Bound bound);
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,42 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+// Compile-time Zobrist keys: one key per (cell, side) plus a side-to-move key.
+// Generated with splitmix64 from a fixed seed so hashes are stable across runs.
+namespace Zobrist
+{
+constexpr int CELLS = 256; // Board::MAX_CELLS
+
+constexpr uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr std::array<uint64_t, CELLS * 2 + 1> makeKeys()
+{
+    std::array<uint64_t, CELLS * 2 + 1> keys{};
+    uint64_t state = 0x5EED0F7AC7AC70EULL;
+    for (auto& key : keys) {
+        key = splitmix64(state);
+    }
+    return keys;
+}
+
+inline constexpr std::array<uint64_t, CELLS * 2 + 1> KEYS = makeKeys();
+
+// side: 0 for X, 1 for O
+constexpr uint64_t cellKey(int cell, int side)
+{
+    return KEYS[cell * 2 + side];
+}
+
+constexpr uint64_t SIDE_TO_MOVE = KEYS[CELLS * 2];
+}
+
+#endif // ZOBRIST_H
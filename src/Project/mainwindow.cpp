@@ -1,9 +1,14 @@
 #include "MainWindow.h"
 #include <QApplication>
 #include <QScreen>
+#include <QThread>
+#include <QSaveFile>
+#include <memory>
+#include "BackgroundCache.h"
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), currentPlayer("X"), gameActive(true), currentStep(0), isFullScreen(true)
+    : QMainWindow(parent), currentPlayer("X"), boardSize(3), winLength(3), gameActive(true),
+      currentStep(0), isFullScreen(true)
 {
     // Initialize pointers to nullptr first
     stackedWidget = nullptr;
@@ -11,6 +16,7 @@ MainWindow::MainWindow(QWidget *parent)
     gameWidget = nullptr;
     board = nullptr;
     aiPlayer = nullptr;  // Single AI player
+    asyncAI = nullptr;
     aiTimer = nullptr;
     toolBar = nullptr;
 
@@ -19,11 +25,25 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize objects safely
     board = new Board();
     aiPlayer = new AIPlayer(AIPlayer::MEDIUM);  // Default to hard difficulty
+    asyncAI = new AsyncAIPlayer(aiPlayer, this);
     aiTimer = new QTimer(this);
     aiTimer->setSingleShot(true);
+    // Smooth rescaling waits until a live resize has settled
+    backgroundTimer = new QTimer(this);
+    backgroundTimer->setSingleShot(true);
+    backgroundTimer->setInterval(150);
+    connect(backgroundTimer, &QTimer::timeout, this, &MainWindow::setBackgroundImage);
+    // All file I/O runs on the persistence thread. The history is synced
+    // once per batch of writes rather than after every record.
+    historyStore.setSyncPolicy(GameHistoryStore::SyncOnClose);
+    persistence.setBatchFinished([this]() { historyStore.sync(); });
+    persistence.enqueue([this]() { historyStore.open(); });
+    persistence.enqueue([this]() { loadUsers(); });
 
     // Setup UI BEFORE setting window properties
     setupUI();
+    // Sign-in waits for the accounts to arrive from the persistence thread
+    loginWidget->setEnabled(false);
     setupToolbar();
     setupStyling();
 
@@ -44,6 +64,8 @@ MainWindow::MainWindow(QWidget *parent)
     }
 
     connect(aiTimer, &QTimer::timeout, this, &MainWindow::makeAIMove);
+    connect(asyncAI, &AsyncAIPlayer::moveReady, this, &MainWindow::onAIMoveReady);
+    connect(asyncAI, &AsyncAIPlayer::searchFinished, this, &MainWindow::onAISearchFinished);
 }
 
 
@@ -85,6 +107,18 @@ void MainWindow::setupLoginView()
     modeComboBox->addItem("🤖 Player vs AI");
     modeComboBox->setObjectName("modeComboBox");
 
+    // Board variant: item data holds the size, UserRole + 1 the win length
+    boardSizeComboBox = new QComboBox(scrollContent);
+    boardSizeComboBox->addItem("▦ Classic 3x3 (3 in a row)", 3);
+    boardSizeComboBox->setItemData(0, 3, Qt::UserRole + 1);
+    boardSizeComboBox->addItem("▦ 4x4 (4 in a row)", 4);
+    boardSizeComboBox->setItemData(1, 4, Qt::UserRole + 1);
+    boardSizeComboBox->addItem("▦ 5x5 (4 in a row)", 5);
+    boardSizeComboBox->setItemData(2, 4, Qt::UserRole + 1);
+    boardSizeComboBox->addItem("▦ 15x15 Gomoku (5 in a row)", 15);
+    boardSizeComboBox->setItemData(3, 5, Qt::UserRole + 1);
+    boardSizeComboBox->setObjectName("modeComboBox");
+
     continueButton = new QPushButton("Continue", scrollContent);
     continueButton->setObjectName("primaryButton");
 
@@ -143,6 +177,8 @@ void MainWindow::setupLoginView()
     scrollLayout->addSpacing(8);
     scrollLayout->addWidget(modeComboBox);
     scrollLayout->addSpacing(8);
+    scrollLayout->addWidget(boardSizeComboBox);
+    scrollLayout->addSpacing(8);
     scrollLayout->addWidget(continueButton);
     scrollLayout->addSpacing(10);
     scrollLayout->addWidget(playerLabel);
@@ -259,6 +295,13 @@ void MainWindow::setupGameView()
     statusLabel->setObjectName("statusLabel");
     statusLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
 
+    // What the AI's last search did, filled in after each AI move
+    searchStatsLabel = new QLabel(leftPanel);
+    searchStatsLabel->setAlignment(Qt::AlignCenter);
+    searchStatsLabel->setObjectName("searchStatsLabel");
+    searchStatsLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+    searchStatsLabel->setWordWrap(true);
+
     // Difficulty selection (NEW!)
     difficultyLabel = new QLabel("🎯 AI Difficulty:", leftPanel);
     difficultyLabel->setAlignment(Qt::AlignCenter);
@@ -279,6 +322,7 @@ void MainWindow::setupGameView()
     leftLayout->addWidget(playersLabel);
     leftLayout->addSpacing(5);
     leftLayout->addWidget(statusLabel);
+    leftLayout->addWidget(searchStatsLabel);
     leftLayout->addSpacing(8);
     leftLayout->addWidget(difficultyLabel);
     leftLayout->addWidget(difficultyComboBox);
@@ -326,34 +370,75 @@ void MainWindow::setupGameGrid()
     gameGridWidget->setMaximumSize(800, 800);
 
     gameGridLayout = new QGridLayout(gameGridWidget);
-    gameGridLayout->setSpacing(20);
     gameGridLayout->setContentsMargins(30, 30, 30, 30);
 
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            gameButtons[i][j] = new QPushButton("", gameGridWidget);
+    rebuildGameGrid();
+}
+
+void MainWindow::rebuildGameGrid()
+{
+    // Drop the buttons of the previous board size
+    for (auto& row : gameButtons) {
+        for (BoardCell* cell : row) {
+            gameGridLayout->removeWidget(cell);
+            cell->deleteLater();
+        }
+    }
+    for (int i = 0; i < gameButtons.size(); ++i) {
+        gameGridLayout->setRowStretch(i, 0);
+        gameGridLayout->setColumnStretch(i, 0);
+    }
+
+    // Shrink cells and spacing so larger boards still fit the grid widget
+    int spacing = boardSize <= 3 ? 20 : (boardSize <= 5 ? 12 : 4);
+    int minCell = boardSize <= 3 ? 140 : std::max(28, 440 / boardSize - spacing);
+    int maxCell = boardSize <= 3 ? 200 : std::max(minCell, 740 / boardSize - spacing);
+    // Selects the #gameButton border rules; the marks size themselves
+    QString density = boardSize <= 3 ? "classic" : (boardSize <= 5 ? "medium" : "dense");
+
+    gameGridLayout->setSpacing(spacing);
+    gameButtons = QVector<QVector<BoardCell*>>(boardSize, QVector<BoardCell*>(boardSize, nullptr));
+
+    for (int i = 0; i < boardSize; ++i) {
+        for (int j = 0; j < boardSize; ++j) {
+            gameButtons[i][j] = new BoardCell(i, j, gameGridWidget);
             gameButtons[i][j]->setObjectName("gameButton");
+            gameButtons[i][j]->setProperty("density", density);
 
-            gameButtons[i][j]->setMinimumSize(140, 140);
-            gameButtons[i][j]->setMaximumSize(200, 200);
+            gameButtons[i][j]->setMinimumSize(minCell, minCell);
+            gameButtons[i][j]->setMaximumSize(maxCell, maxCell);
 
             gameButtons[i][j]->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
 
-            gameButtons[i][j]->setProperty("row", i);
-            gameButtons[i][j]->setProperty("col", j);
-
             connect(gameButtons[i][j], &QPushButton::clicked, this, &MainWindow::onGameButtonClicked);
 
             gameGridLayout->addWidget(gameButtons[i][j], i, j);
         }
     }
 
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < boardSize; ++i) {
         gameGridLayout->setRowStretch(i, 1);
         gameGridLayout->setColumnStretch(i, 1);
     }
 }
 
+void MainWindow::setBoardVariant(int size, int length)
+{
+    if (size == boardSize && length == winLength) {
+        return;
+    }
+
+    asyncAI->cancel();
+    boardSize = size;
+    winLength = length;
+    delete board;
+    board = new Board(boardSize, winLength);
+    moveHistory = MoveSequence(boardSize);
+    // 3x3 is solved instantly; larger boards split the search across cores
+    aiPlayer->setThreadCount(boardSize > 3 ? QThread::idealThreadCount() : 1);
+    rebuildGameGrid();
+}
+
 void MainWindow::setupToolbar()
 {
     toolBar = addToolBar("Game Controls");
@@ -385,6 +470,10 @@ void MainWindow::onDifficultyChanged(int index)
         return;
     }
 
+    // Drop any search still running with the old difficulty
+    aiTimer->stop();
+    asyncAI->cancel();
+
     // Switch AI difficulty
     QString message;
     switch (index) {
@@ -482,27 +571,12 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
 
 void MainWindow::switchToGameView()
 {
+    setBoardVariant(boardSizeComboBox->currentData().toInt(),
+                    boardSizeComboBox->currentData(Qt::UserRole + 1).toInt());
+
     stackedWidget->setCurrentWidget(gameWidget);
     toolBar->setVisible(true);
-    QPixmap background;
-
-    // Safe to check current widget
-    if (stackedWidget->currentWidget() == loginWidget) {
-        background.load("D:/images/login_bg.jpg");
-    } else {
-        background.load("D:/images/game_bg.jpg");
-    }
-
-    if (!background.isNull()) {
-        background = background.scaled(this->size(),
-                                       Qt::KeepAspectRatioByExpanding,
-                                       Qt::SmoothTransformation);
-
-        QPalette palette;
-        palette.setBrush(QPalette::Window, background);
-        this->setPalette(palette);
-        this->setAutoFillBackground(true);
-    }
+    setBackgroundImage();
     // Show/hide difficulty based on game mode
     if (difficultyLabel && difficultyComboBox) {
         bool showDifficulty = (gameMode == "PvAI");
@@ -521,6 +595,7 @@ void MainWindow::resetToModeSelection()
     instructionLabel->setText("Welcome! Choose your game mode:");
     instructionLabel->show();
     modeComboBox->show();
+    boardSizeComboBox->show();
     continueButton->show();
 
     playerLabel->hide();
@@ -556,6 +631,7 @@ void MainWindow::showPlayer1Auth()
 
     instructionLabel->hide();
     modeComboBox->hide();
+    boardSizeComboBox->hide();
     continueButton->hide();
 
     playerLabel->setText("🎮 Player 1 Authentication");
@@ -599,8 +675,9 @@ void MainWindow::showGameStart()
     newPlayerButton->hide();
     nextPlayerButton->hide();
 
-    QString info = QString("🎯 Game Mode: %1\n👤 Player 1: %2")
+    QString info = QString("🎯 Game Mode: %1\n▦ Board: %2\n👤 Player 1: %3")
                        .arg(gameMode == "PvP" ? "Player vs Player" : "Player vs AI")
+                       .arg(boardSizeComboBox->currentText().mid(2))
                        .arg(player1Name);
 
     if (gameMode == "PvP") {
@@ -734,39 +811,28 @@ void MainWindow::onLogoutClicked()
         toolBar->setVisible(false);  // Hide toolbar in login view
         resetToModeSelection();
     }
-    QPixmap background;
-
-    // Safe to check current widget
-    if (stackedWidget->currentWidget() == loginWidget) {
-        background.load("D:/images/login_bg.jpg");
-    } else {
-        background.load("D:/images/login_bg.jpg");
-    }
-
-    if (!background.isNull()) {
-        background = background.scaled(this->size(),
-                                       Qt::KeepAspectRatioByExpanding,
-                                       Qt::SmoothTransformation);
+    setBackgroundImage();
+}
 
-        QPalette palette;
-        palette.setBrush(QPalette::Window, background);
-        this->setPalette(palette);
-        this->setAutoFillBackground(true);
+// Runs on the persistence thread and posts the accounts to the GUI thread,
+// which keeps users in memory and is the only thread that touches it
+void MainWindow::loadUsers()
+{
+    QJsonObject loaded;
+    QFile file("users.json");
+    if (file.open(QIODevice::ReadOnly)) {
+        loaded = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
     }
+    QMetaObject::invokeMethod(this, [this, loaded]() {
+        users = loaded;
+        loginWidget->setEnabled(true);
+    }, Qt::QueuedConnection);
 }
 
 // Authentication methods (same as before)
 bool MainWindow::authenticateUser(const QString& username, const QString& password)
 {
-    QFile file("users.json");
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    QJsonObject users = doc.object();
-    file.close();
-
     if (users.contains(username)) {
         QString storedHash = users[username].toString();
         QString inputHash = hashPassword(password);
@@ -778,29 +844,22 @@ bool MainWindow::authenticateUser(const QString& username, const QString& passwo
 
 bool MainWindow::registerUser(const QString& username, const QString& password)
 {
-    QFile file("users.json");
-    QJsonObject users;
-
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        users = doc.object();
-        file.close();
-    }
-
     if (users.contains(username)) {
         return false;
     }
 
     users[username] = hashPassword(password);
 
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonDocument doc(users);
-        file.write(doc.toJson());
-        file.close();
-        return true;
-    }
-
-    return false;
+    // Each write is a full snapshot, so a newer one replaces any still queued
+    QByteArray snapshot = QJsonDocument(users).toJson();
+    persistence.enqueue([snapshot]() {
+        QSaveFile file("users.json");
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(snapshot);
+            file.commit();
+        }
+    }, "users.json");
+    return true;
 }
 
 QString MainWindow::hashPassword(const QString& password)
@@ -813,25 +872,20 @@ void MainWindow::onGameButtonClicked()
 {
    if (!gameActive || !board) return;  // Add board null check
 
-    QPushButton* button = qobject_cast<QPushButton*>(sender());
-    if (!button || !button->text().isEmpty()) return;
-
-    int row = button->property("row").toInt();
-    int col = button->property("col").toInt();
+    // Ignore clicks while the AI is choosing its move
+    if (gameMode == "PvAI" && currentPlayer == "O") return;
 
-    if (board->makeMove(row, col, currentPlayer.at(0).toLatin1())) {
-        button->setText(currentPlayer);
+    BoardCell* cell = qobject_cast<BoardCell*>(sender());
+    if (!cell || cell->mark()) return;
 
-        if (currentPlayer == "X") {
-            button->setStyleSheet(button->styleSheet() + " color: #FF1493; text-shadow: 0 0 15px #FF1493;");
-        } else {
-            button->setStyleSheet(button->styleSheet() + " color: #00FFFF; text-shadow: 0 0 15px #00FFFF;");
-        }
+    int row = cell->row();
+    int col = cell->col();
 
-        animateButton(button);
+    if (board->makeMove(row, col, currentPlayer.at(0).toLatin1())) {
+        cell->setMark(currentPlayer.at(0).toLatin1());
+        animateButton(cell);
 
-        QString move = QString("%1%2%3").arg(currentPlayer).arg(row).arg(col);
-        moveHistory.append(move);
+        moveHistory.append(row, col);
 
         checkGameEnd();
 
@@ -849,36 +903,52 @@ void MainWindow::onGameButtonClicked()
 
 void MainWindow::makeAIMove()
 {
-    if (!gameActive || currentPlayer != "O" || !board || !aiPlayer) return;
-
-    auto availableMoves = board->getAvailableMoves();
-    if (!availableMoves.empty()) {
-        auto move = aiPlayer->getMove(board);  // Uses current difficulty setting
-        int row = move.first;
-        int col = move.second;
-
-        // Validate move coordinates
-        if (row >= 0 && row < 3 && col >= 0 && col < 3) {
-            if (board->makeMove(row, col, 'O')) {
-                gameButtons[row][col]->setText("O");
-                gameButtons[row][col]->setStyleSheet(gameButtons[row][col]->styleSheet() +
-                                                     " color: #00FFFF; text-shadow: 0 0 15px #00FFFF;");
-                animateButton(gameButtons[row][col]);
-
-                QString moveStr = QString("O%1%2").arg(row).arg(col);
-                moveHistory.append(moveStr);
-
-                checkGameEnd();
-
-                if (gameActive) {
-                    currentPlayer = "X";
-                    updateGameStatus();
-                }
+    if (!gameActive || currentPlayer != "O" || !board || !asyncAI) return;
+
+    if (!board->getAvailableMoves().empty()) {
+        // Search runs on a worker thread; the result arrives in onAIMoveReady
+        asyncAI->requestMove(*board);
+    }
+}
+
+void MainWindow::onAIMoveReady(int row, int col)
+{
+    if (!gameActive || currentPlayer != "O" || !board) return;
+
+    // Validate move coordinates
+    if (row >= 0 && row < boardSize && col >= 0 && col < boardSize) {
+        if (board->makeMove(row, col, 'O')) {
+            gameButtons[row][col]->setMark('O');
+            animateButton(gameButtons[row][col]);
+
+            moveHistory.append(row, col);
+
+            checkGameEnd();
+
+            if (gameActive) {
+                currentPlayer = "X";
+                updateGameStatus();
             }
         }
     }
 }
 
+void MainWindow::onAISearchFinished(const AIPlayer::SearchStats& stats)
+{
+    QString text = QString("🔍 %1 nodes · %2 ms").arg(stats.nodes).arg(stats.wallTimeMs, 0, 'f', 1);
+    if (stats.completedDepth > 0) {
+        double firstMove = stats.cutoffs > 0 ? 100.0 * stats.firstMoveCutoffs / stats.cutoffs : 0.0;
+        text += QString("\ndepth %1 (ply %2) · %3 cutoffs (%4% first move) · TT %5/%6 · branching %7")
+                    .arg(stats.completedDepth)
+                    .arg(stats.maxPly)
+                    .arg(stats.cutoffs)
+                    .arg(firstMove, 0, 'f', 0)
+                    .arg(stats.tableHits)
+                    .arg(stats.tableProbes)
+                    .arg(stats.branchingFactor, 0, 'f', 2);
+    }
+    searchStatsLabel->setText(text);
+}
 
 void MainWindow::animateButton(QPushButton* button)
 {
@@ -969,12 +1039,8 @@ void MainWindow::showGameOverDialog(const QString& result)
     gameOverDialog->setFixedSize(450, 350);
     gameOverDialog->setModal(true);
 
-    QPixmap xoxoBackground("D:/images/gameover_bg.jpg");
+    QPixmap xoxoBackground = BackgroundCache::scaled("gameover_bg.jpg", gameOverDialog->size());
     if (!xoxoBackground.isNull()) {
-        xoxoBackground = xoxoBackground.scaled(gameOverDialog->size(),
-                                               Qt::KeepAspectRatioByExpanding,
-                                               Qt::SmoothTransformation);
-
         QPalette palette;
         palette.setBrush(QPalette::Window, xoxoBackground);
         gameOverDialog->setPalette(palette);
@@ -1053,38 +1119,24 @@ void MainWindow::showGameOverDialog(const QString& result)
 
 void MainWindow::saveGameHistory(const QString& winner)
 {
-    QFile file("game_history.json");
-    QJsonObject history;
-
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        history = doc.object();
-        file.close();
-    }
-
-    QJsonObject gameData;
-    gameData["winner"] = winner;
-    gameData["mode"] = gameMode;
-    gameData["opponent"] = player2Name;
-
-    QJsonArray movesArray;
-    for (const QString& move : moveHistory) {
-        movesArray.append(move);
-    }
-    gameData["moves"] = movesArray;
-
-    QJsonArray userGames;
-    if (history.contains(player1Name)) {
-        userGames = history[player1Name].toArray();
-    }
-    userGames.append(gameData);
-    history[player1Name] = userGames;
-
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonDocument doc(history);
-        file.write(doc.toJson());
-        file.close();
+    // One record appended to the log, however long the history already is
+    GameRecord game;
+    game.player = player1Name;
+    game.winner = winner;
+    game.mode = gameMode;
+    game.opponent = player2Name;
+    game.boardSize = boardSize;
+    game.winLength = winLength;
+    game.moves = moveHistory;
+    if (gameMode == "PvAI") {
+        switch (aiPlayer->getDifficulty()) {
+        case AIPlayer::EASY: game.difficulty = "Easy"; break;
+        case AIPlayer::MEDIUM: game.difficulty = "Medium"; break;
+        case AIPlayer::HARD: default: game.difficulty = "Hard"; break;
+        }
     }
+    // Appending also updates the player's running stats
+    persistence.enqueue([this, game]() mutable { historyStore.appendGame(game); });
 }
 
 void MainWindow::onNewGameClicked()
@@ -1097,8 +1149,28 @@ void MainWindow::onShowHistoryClicked()
     showGameHistoryDialog();
 }
 
-// Keep all existing history methods exactly the same
+// The index and stats belong to the persistence thread, so they are copied
+// there, after every queued write has landed, and the dialog opens once the
+// copy is posted back
 void MainWindow::showGameHistoryDialog()
+{
+    historyAction->setEnabled(false);
+    QString player = player1Name;
+    persistence.enqueue([this, player]() {
+        QVector<GameHistoryStore::GameRef> refs = historyStore.gameRefs(player);
+        PlayerStats stats = historyStore.playerStats(player);
+        QMetaObject::invokeMethod(this, [this, player, refs, stats]() {
+            historyAction->setEnabled(true);
+            // Skipped if the player logged out in the meantime
+            if (player == player1Name && stackedWidget->currentWidget() == gameWidget) {
+                openGameHistoryDialog(refs, stats);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::openGameHistoryDialog(const QVector<GameHistoryStore::GameRef>& refs,
+                                       const PlayerStats& stats)
 {
     QDialog* historyDialog = new QDialog(this);
     historyDialog->setWindowTitle("Game History");
@@ -1106,12 +1178,8 @@ void MainWindow::showGameHistoryDialog()
     historyDialog->setModal(true);
 
     // Set background for history dialog
-    QPixmap historyBackground("D:/images/gameover_bg.jpg");
+    QPixmap historyBackground = BackgroundCache::scaled("gameover_bg.jpg", historyDialog->size());
     if (!historyBackground.isNull()) {
-        historyBackground = historyBackground.scaled(historyDialog->size(),
-                                                     Qt::KeepAspectRatioByExpanding,
-                                                     Qt::SmoothTransformation);
-
         QPalette palette;
         palette.setBrush(QPalette::Window, historyBackground);
         historyDialog->setPalette(palette);
@@ -1139,10 +1207,11 @@ void MainWindow::showGameHistoryDialog()
         }
     )");
 
-    // Games list
-    QListWidget* gamesList = new QListWidget(historyDialog);
+    // Games list, read from the log a page at a time as it scrolls
+    QListView* gamesList = new QListView(historyDialog);
+    gamesList->setUniformItemSizes(true);
     gamesList->setStyleSheet(R"(
-        QListWidget {
+        QListView {
             background: rgba(0, 0, 0, 0.8);
             color: white;
             border: 2px solid #8A2BE2;
@@ -1150,71 +1219,49 @@ void MainWindow::showGameHistoryDialog()
             font-size: 14px;
             padding: 10px;
         }
-        QListWidget::item {
+        QListView::item {
             background: rgba(75, 0, 130, 0.6);
             border: 1px solid #9370DB;
             border-radius: 8px;
             padding: 10px;
             margin: 3px;
         }
-        QListWidget::item:selected {
+        QListView::item:selected {
             background: rgba(138, 43, 226, 0.8);
             border: 2px solid #FF1493;
         }
-        QListWidget::item:hover {
+        QListView::item:hover {
             background: rgba(106, 90, 205, 0.7);
             border: 1px solid #BA55D3;
         }
     )");
 
-    // Load game history
-    QFile file("game_history.json");
-    QJsonArray userGames;
+    HistoryListModel* historyModel = new HistoryListModel(&historyStore, &persistence, player1Name,
+                                                          refs, historyDialog);
+    gamesList->setModel(historyModel);
 
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        QJsonObject history = doc.object();
-        file.close();
-
-        if (history.contains(player1Name)) {
-            userGames = history[player1Name].toArray();
-        }
-    }
-
-    // Populate games list
-    for (int i = 0; i < userGames.size(); ++i) {
-        QJsonObject gameData = userGames[i].toObject();
-        QString winner = gameData["winner"].toString();
-        QString mode = gameData["mode"].toString();
-        QString opponent = gameData["opponent"].toString();
-        QJsonArray moves = gameData["moves"].toArray();
-
-        QString resultText;
-        if (winner == "T") {
-            resultText = "🤝 Tie";
-        } else if (winner == "X") {
-            resultText = QString("🎉 %1 Won").arg(player1Name);
-        } else {
-            if (mode == "PvAI") {
-                resultText = "🤖 AI Won";
-            } else {
-                resultText = QString("🎉 %1 Won").arg(opponent);
-            }
+    // Filters
+    QString filterStyle = R"(
+        QComboBox {
+            background: rgba(0, 0, 0, 0.8);
+            color: white;
+            border: 2px solid #8A2BE2;
+            border-radius: 8px;
+            font-size: 14px;
+            padding: 5px 10px;
         }
-
-        QString modeText = (mode == "PvP") ? "Player vs Player" : "Player vs AI";
-        QString itemText = QString("Game #%1 | %2 | %3 vs %4 | %5 moves | %6")
-                               .arg(i + 1)
-                               .arg(resultText)
-                               .arg(player1Name)
-                               .arg(opponent)
-                               .arg(moves.size())
-                               .arg(modeText);
-
-        QListWidgetItem* item = new QListWidgetItem(itemText);
-        item->setData(Qt::UserRole, gameData);
-        gamesList->addItem(item);
-    }
+    )";
+    QComboBox* resultFilter = new QComboBox(historyDialog);
+    resultFilter->addItems({"All Results", "Wins", "Losses", "Ties"});
+    resultFilter->setStyleSheet(filterStyle);
+    QComboBox* modeFilter = new QComboBox(historyDialog);
+    modeFilter->addItems({"All Modes", "Player vs Player", "Player vs AI"});
+    modeFilter->setStyleSheet(filterStyle);
+
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(resultFilter);
+    filterLayout->addWidget(modeFilter);
+    filterLayout->addStretch();
 
     // Buttons layout
     QHBoxLayout* buttonLayout = new QHBoxLayout();
@@ -1222,6 +1269,7 @@ void MainWindow::showGameHistoryDialog()
     QPushButton* replayButton = new QPushButton("🎬 Replay Game", historyDialog);
     QPushButton* deleteButton = new QPushButton("🗑️ Delete Game", historyDialog);
     QPushButton* clearAllButton = new QPushButton("🧹 Clear All", historyDialog);
+    QPushButton* exportButton = new QPushButton("💾 Export", historyDialog);
     QPushButton* closeButton = new QPushButton("✕ Close", historyDialog);
 
     QString buttonStyle = R"(
@@ -1258,34 +1306,40 @@ void MainWindow::showGameHistoryDialog()
     replayButton->setStyleSheet(buttonStyle);
     deleteButton->setStyleSheet(buttonStyle);
     clearAllButton->setStyleSheet(buttonStyle);
+    exportButton->setStyleSheet(buttonStyle);
     closeButton->setStyleSheet(buttonStyle);
 
     // Initially disable buttons
     replayButton->setEnabled(false);
     deleteButton->setEnabled(false);
-    clearAllButton->setEnabled(userGames.size() > 0);
+    clearAllButton->setEnabled(historyModel->totalCount() > 0);
+    exportButton->setEnabled(historyModel->totalCount() > 0);
 
     buttonLayout->addWidget(replayButton);
     buttonLayout->addWidget(deleteButton);
     buttonLayout->addStretch();
+    buttonLayout->addWidget(exportButton);
     buttonLayout->addWidget(clearAllButton);
     buttonLayout->addWidget(closeButton);
 
-    // Stats label
+    // Stats label, from the totals the store keeps as games are saved
     QLabel* statsLabel = new QLabel(historyDialog);
-    if (userGames.size() == 0) {
+    if (stats.overall.total() == 0) {
         statsLabel->setText("📈 No games played yet. Start playing to build your history!");
     } else {
-        int wins = 0, losses = 0, ties = 0;
-        for (int i = 0; i < userGames.size(); ++i) {
-            QString winner = userGames[i].toObject()["winner"].toString();
-            if (winner == "X") wins++;
-            else if (winner == "O") losses++;
-            else ties++;
-        }
-
-        statsLabel->setText(QString("📈 Stats: %1 Wins | %2 Losses | %3 Ties | Total: %4 games")
-                                .arg(wins).arg(losses).arg(ties).arg(userGames.size()));
+        QString streak = "-";
+        if (stats.currentStreak > 0) {
+            streak = QString("%1 W").arg(stats.currentStreak);
+        } else if (stats.currentStreak < 0) {
+            streak = QString("%1 L").arg(-stats.currentStreak);
+        }
+
+        statsLabel->setText(QString("📈 Stats: %1 Wins | %2 Losses | %3 Ties | Total: %4 games\n"
+                                    "🔥 Streak: %5 | Best: %6 W | Avg length: %7 moves")
+                                .arg(stats.overall.wins).arg(stats.overall.losses)
+                                .arg(stats.overall.ties).arg(stats.overall.total())
+                                .arg(streak).arg(stats.longestWinStreak)
+                                .arg(stats.averageLength(), 0, 'f', 1));
     }
 
     statsLabel->setStyleSheet(R"(
@@ -1305,34 +1359,45 @@ void MainWindow::showGameHistoryDialog()
     // Add widgets to layout
     mainLayout->addWidget(titleLabel);
     mainLayout->addWidget(statsLabel);
+    mainLayout->addLayout(filterLayout);
     mainLayout->addWidget(gamesList, 1);
     mainLayout->addLayout(buttonLayout);
 
     // Connect signals
-    connect(gamesList, &QListWidget::itemSelectionChanged, [=]() {
-        bool hasSelection = gamesList->currentItem() != nullptr;
+    connect(gamesList->selectionModel(), &QItemSelectionModel::selectionChanged, [=]() {
+        bool hasSelection = gamesList->selectionModel()->hasSelection();
         replayButton->setEnabled(hasSelection);
         deleteButton->setEnabled(hasSelection);
     });
 
+    // A model reset drops the selection without signalling it
+    auto applyFilter = [=]() {
+        historyModel->setFilter(
+            static_cast<HistoryListModel::ResultFilter>(resultFilter->currentIndex()),
+            static_cast<HistoryListModel::ModeFilter>(modeFilter->currentIndex()));
+        replayButton->setEnabled(false);
+        deleteButton->setEnabled(false);
+    };
+    connect(resultFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), applyFilter);
+    connect(modeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), applyFilter);
+
     connect(replayButton, &QPushButton::clicked, [=]() {
-        QListWidgetItem* item = gamesList->currentItem();
-        if (item) {
-            QJsonObject gameData = item->data(Qt::UserRole).toJsonObject();
+        QModelIndex current = gamesList->currentIndex();
+        if (current.isValid() && historyModel->isLoaded(current.row())) {
+            GameRecord game = historyModel->game(current.row());
             historyDialog->accept();
-            replayGame(gameData);
+            replayGame(game);
         }
     });
 
     connect(deleteButton, &QPushButton::clicked, [=]() {
-        QListWidgetItem* item = gamesList->currentItem();
-        if (item) {
+        QModelIndex current = gamesList->currentIndex();
+        if (current.isValid()) {
             int ret = QMessageBox::question(historyDialog, "Delete Game",
                                             "Are you sure you want to delete this game?",
                                             QMessageBox::Yes | QMessageBox::No);
             if (ret == QMessageBox::Yes) {
-                int row = gamesList->row(item);
-                deleteGameFromHistory(row);
+                deleteGameFromHistory(current.data(Qt::UserRole).toULongLong());
                 historyDialog->accept();
                 showGameHistoryDialog(); // Refresh the dialog
             }
@@ -1345,28 +1410,25 @@ void MainWindow::showGameHistoryDialog()
                                         QMessageBox::Yes | QMessageBox::No);
         if (ret == QMessageBox::Yes) {
             // Clear all history for current user
-            QFile file("game_history.json");
-            QJsonObject history;
-
-            if (file.open(QIODevice::ReadOnly)) {
-                QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-                history = doc.object();
-                file.close();
-            }
-
-            history.remove(player1Name);
-
-            if (file.open(QIODevice::WriteOnly)) {
-                QJsonDocument doc(history);
-                file.write(doc.toJson());
-                file.close();
-            }
+            QString player = player1Name;
+            persistence.enqueue([this, player]() { historyStore.clearPlayer(player); });
 
             historyDialog->accept();
             QMessageBox::information(this, "History Cleared", "All game history has been cleared!");
         }
     });
 
+    // The log keeps moves in compact form; JSON is only written on export
+    connect(exportButton, &QPushButton::clicked, [=]() {
+        QString jsonPath = QFileDialog::getSaveFileName(historyDialog, "Export Game History",
+                                                        player1Name + "_history.json",
+                                                        "JSON files (*.json)");
+        if (!jsonPath.isEmpty()) {
+            QString player = player1Name;
+            persistence.enqueue([this, player, jsonPath]() { historyStore.exportJson(player, jsonPath); });
+        }
+    });
+
     connect(closeButton, &QPushButton::clicked, historyDialog, &QDialog::accept);
 
     historyDialog->exec();
@@ -1374,14 +1436,18 @@ void MainWindow::showGameHistoryDialog()
 }
 
 
-void MainWindow::replayGame(const QJsonObject& gameData)
+void MainWindow::replayGame(const GameRecord& game)
 {
+    // Replay on the board variant the game was played on
+    int previousSize = boardSize;
+    int previousWinLength = winLength;
+    setBoardVariant(game.boardSize, game.winLength);
+
     // Reset the game board
     resetGame();
 
-    QJsonArray moves = gameData["moves"].toArray();
-    QString mode = gameData["mode"].toString();
-    QString opponent = gameData["opponent"].toString();
+    MoveSequence moves = game.moves;
+    QString opponent = game.opponent;
 
     // Create larger replay dialog
     QDialog* replayDialog = new QDialog(this);
@@ -1390,12 +1456,8 @@ void MainWindow::replayGame(const QJsonObject& gameData)
     replayDialog->setModal(true);
 
     // Set background
-    QPixmap replayBackground("D:/images/gameover_bg.jpg");
+    QPixmap replayBackground = BackgroundCache::scaled("gameover_bg.jpg", replayDialog->size());
     if (!replayBackground.isNull()) {
-        replayBackground = replayBackground.scaled(replayDialog->size(),
-                                                   Qt::KeepAspectRatioByExpanding,
-                                                   Qt::SmoothTransformation);
-
         QPalette palette;
         palette.setBrush(QPalette::Window, replayBackground);
         replayDialog->setPalette(palette);
@@ -1489,40 +1551,39 @@ void MainWindow::replayGame(const QJsonObject& gameData)
     layout->addLayout(buttonLayout);
     layout->addStretch();    // Push everything up, leaving space at bottom
 
-    int currentMoveIndex = 0;
+    // One counter shared by the Next button, Auto Play and the timer, so a
+    // move is never played twice and a failed move means a damaged record
+    auto currentMoveIndex = std::make_shared<int>(0);
     QTimer* autoTimer = new QTimer(replayDialog);
     autoTimer->setSingleShot(false);
     autoTimer->setInterval(1000); // 1 seconds between moves
 
-    auto playNextMove = [=]() mutable {
-        if (currentMoveIndex < moves.size()) {
-            QString move = moves[currentMoveIndex].toString();
-            char player = move[0].toLatin1();
-            int row = move[1].digitValue();
-            int col = move[2].digitValue();
-
-            // Make the move on the board
-            board->makeMove(row, col, player);
-            gameButtons[row][col]->setText(QString(player));
-
-            // Apply color styling
-            if (player == 'X') {
-                gameButtons[row][col]->setStyleSheet(gameButtons[row][col]->styleSheet() +
-                                                     " color: #FF1493; text-shadow: 0 0 15px #FF1493;");
-            } else {
-                gameButtons[row][col]->setStyleSheet(gameButtons[row][col]->styleSheet() +
-                                                     " color: #00FFFF; text-shadow: 0 0 15px #00FFFF;");
+    auto playNextMove = [=]() {
+        if (*currentMoveIndex < moves.size()) {
+            Move move = moves.at(*currentMoveIndex);
+            char player = MoveSequence::playerAt(*currentMoveIndex);
+            int row = move.row;
+            int col = move.col;
+            if (!board->makeMove(row, col, player)) {
+                *currentMoveIndex = moves.size();
+                moveLabel->setText("⚠️ Replay stopped: this game record is damaged.");
+                nextButton->setEnabled(false);
+                autoButton->setEnabled(false);
+                autoTimer->stop();
+                return;
             }
 
-            currentMoveIndex++;
+            gameButtons[row][col]->setMark(player);
+
+            ++*currentMoveIndex;
             moveLabel->setText(QString("Move %1/%2: Player %3 at position (%4,%5)")
-                                   .arg(currentMoveIndex)
+                                   .arg(*currentMoveIndex)
                                    .arg(moves.size())
                                    .arg(player)
                                    .arg(row + 1)
                                    .arg(col + 1));
 
-            if (currentMoveIndex >= moves.size()) {
+            if (*currentMoveIndex >= moves.size()) {
                 nextButton->setEnabled(false);
                 nextButton->setText("✅ Complete");
                 autoTimer->stop();
@@ -1535,12 +1596,12 @@ void MainWindow::replayGame(const QJsonObject& gameData)
 
     connect(nextButton, &QPushButton::clicked, playNextMove);
 
-    connect(autoButton, &QPushButton::clicked, [=]() mutable {
+    connect(autoButton, &QPushButton::clicked, [=]() {
         if (autoTimer->isActive()) {
             autoTimer->stop();
             autoButton->setText("⏩ Auto Play");
         } else {
-            if (currentMoveIndex < moves.size()) {
+            if (*currentMoveIndex < moves.size()) {
                 autoTimer->start();
                 autoButton->setText("⏸️ Pause");
             }
@@ -1552,47 +1613,36 @@ void MainWindow::replayGame(const QJsonObject& gameData)
 
     replayDialog->exec();
     delete replayDialog;
-}
-
 
-void MainWindow::deleteGameFromHistory(int gameIndex)
-{
-    QFile file("game_history.json");
-    QJsonObject history;
-
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        history = doc.object();
-        file.close();
+    // Back to the variant that was being played
+    if (previousSize != boardSize || previousWinLength != winLength) {
+        setBoardVariant(previousSize, previousWinLength);
+        resetGame();
     }
+}
 
-    if (history.contains(player1Name)) {
-        QJsonArray userGames = history[player1Name].toArray();
-
-        if (gameIndex >= 0 && gameIndex < userGames.size()) {
-            userGames.removeAt(gameIndex);
-            history[player1Name] = userGames;
 
-            if (file.open(QIODevice::WriteOnly)) {
-                QJsonDocument doc(history);
-                file.write(doc.toJson());
-                file.close();
-            }
-        }
-    }
+void MainWindow::deleteGameFromHistory(quint64 gameId)
+{
+    QString player = player1Name;
+    persistence.enqueue([this, player, gameId]() { historyStore.deleteGame(player, gameId); });
 }
 
 void MainWindow::resetGame()
 {
+    // Abandon any AI move still being searched for the old board
+    aiTimer->stop();
+    asyncAI->cancel();
+
     board->reset();
     gameActive = true;
     currentPlayer = "X";
-    moveHistory.clear();
+    moveHistory = MoveSequence(boardSize);
+    searchStatsLabel->clear();
 
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            gameButtons[i][j]->setText("");
-            gameButtons[i][j]->setStyleSheet("");
+    for (int i = 0; i < boardSize; ++i) {
+        for (int j = 0; j < boardSize; ++j) {
+            gameButtons[i][j]->setMark(0);
         }
     }
 
@@ -1871,10 +1921,15 @@ void MainWindow::setupStyling()
                 stop:1 rgba(75, 0, 130, 0.6));
             border: 3px solid #00FFFF;
             border-radius: 15px;
-            color: white;
-            font-size: 56px;
-            font-weight: bold;
-            text-shadow: 0 0 15px currentColor;
+        }
+
+        #gameButton[density="medium"] {
+            border-radius: 10px;
+        }
+
+        #gameButton[density="dense"] {
+            border-width: 1px;
+            border-radius: 4px;
         }
 
         #gameButton:hover {
@@ -1882,7 +1937,6 @@ void MainWindow::setupStyling()
                 stop:0 rgba(255, 20, 147, 0.4),
                 stop:1 rgba(138, 43, 226, 0.4));
             border: 4px solid #FF1493;
-            text-shadow: 0 0 25px currentColor;
         }
 
         #gameButton:pressed {
@@ -1927,6 +1981,15 @@ QToolBar {
             color: #00FFFF;
             border-top: 2px solid #00FFFF;
         }
+#searchStatsLabel {
+    color: #B0E0E6;
+    font-size: 11px;
+    background: rgba(0, 0, 0, 0.6);
+    border-radius: 10px;
+    padding: 6px;
+    margin: 3px;
+}
+
 #difficultyLabel {
     color: #FFD700;
     font-size: 14px;
@@ -1979,22 +2042,14 @@ QToolBar {
     this->setStyleSheet(style);
 }
 
-void MainWindow::setBackgroundImage()
+QString MainWindow::backgroundName() const
 {
-    QPixmap background;
-
-        // Safe to check current widget
-        if (stackedWidget->currentWidget() == loginWidget) {
-            background.load("D:/images/login_bg.jpg");
-        } else {
-            background.load("D:/images/game_bg.jpg");
-        }
+    return stackedWidget->currentWidget() == loginWidget ? "login_bg.jpg" : "game_bg.jpg";
+}
 
+void MainWindow::applyBackground(const QPixmap& background)
+{
     if (!background.isNull()) {
-        background = background.scaled(this->size(),
-                                       Qt::KeepAspectRatioByExpanding,
-                                       Qt::SmoothTransformation);
-
         QPalette palette;
         palette.setBrush(QPalette::Window, background);
         this->setPalette(palette);
@@ -2002,13 +2057,31 @@ void MainWindow::setBackgroundImage()
     }
 }
 
+void MainWindow::setBackgroundImage()
+{
+    backgroundTimer->stop();
+    applyBackground(BackgroundCache::scaled(backgroundName(), this->size()));
+}
+
 void MainWindow::resizeEvent(QResizeEvent* event)
 {
     QMainWindow::resizeEvent(event);
 
-    // Only call setBackgroundImage if widgets are initialized
-    if (stackedWidget && loginWidget && gameWidget) {
-        setBackgroundImage();
+    // Only update the background if widgets are initialized
+    if (!stackedWidget || !loginWidget || !gameWidget) {
+        return;
+    }
+
+    // Sizes seen before (full screen and windowed) are already scaled, so
+    // toggling between them costs nothing. Anything else gets a quick
+    // preview now and a smooth scale once the resize stops.
+    QPixmap background = BackgroundCache::cached(backgroundName(), event->size());
+    if (!background.isNull()) {
+        backgroundTimer->stop();
+        applyBackground(background);
+    } else {
+        applyBackground(BackgroundCache::preview(backgroundName(), event->size()));
+        backgroundTimer->start();
     }
 }
 
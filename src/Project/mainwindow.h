@@ -16,6 +16,8 @@
 #include <QDialog>
 #include <QListWidget>
 #include <QListWidgetItem>
+#include <QListView>
+#include <QFileDialog>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -29,8 +31,14 @@
 #include <QRect>
 #include <QCryptographicHash>
 #include <QKeyEvent>
+#include <QVector>
 #include "Board.h"
 #include "AIPlayer.h"
+#include "AsyncAIPlayer.h"
+#include "GameHistoryStore.h"
+#include "PersistenceWriter.h"
+#include "HistoryListModel.h"
+#include "BoardCell.h"
 #include <QScrollArea>
 #include <QFrame>
 
@@ -63,6 +71,8 @@ private slots:
     void onShowHistoryClicked();
     void onLogoutClicked();
     void makeAIMove();
+    void onAIMoveReady(int row, int col);
+    void onAISearchFinished(const AIPlayer::SearchStats& stats);
     void onDifficultyChanged(int index);
 
 private:
@@ -72,6 +82,8 @@ private:
     void setupGameView();
     void setupStyling();
     void setBackgroundImage();
+    QString backgroundName() const;
+    void applyBackground(const QPixmap& background);
     void updateLayoutForMode();
 
     // Login methods
@@ -79,6 +91,7 @@ private:
     void showPlayer1Auth();
     void showPlayer2Auth();
     void showGameStart();
+    void loadUsers();
     bool authenticateUser(const QString& username, const QString& password);
     bool registerUser(const QString& username, const QString& password);
     QString hashPassword(const QString& password);
@@ -86,6 +99,8 @@ private:
 
     // Game methods
     void setupGameGrid();
+    void rebuildGameGrid();
+    void setBoardVariant(int size, int winLength);
     void setupToolbar();
     void resetGame();
     void updateGameStatus();
@@ -94,8 +109,10 @@ private:
     void showGameOverDialog(const QString& result);
     void animateButton(QPushButton* button);
     void showGameHistoryDialog();
-    void replayGame(const QJsonObject& gameData);
-    void deleteGameFromHistory(int gameIndex);
+    void openGameHistoryDialog(const QVector<GameHistoryStore::GameRef>& refs,
+                               const PlayerStats& stats);
+    void replayGame(const GameRecord& game);
+    void deleteGameFromHistory(quint64 gameId);
 
     // Main UI Components
     QStackedWidget* stackedWidget;
@@ -107,6 +124,7 @@ private:
     QLabel* loginTitleLabel;
     QLabel* instructionLabel;
     QComboBox* modeComboBox;
+    QComboBox* boardSizeComboBox;
     QPushButton* continueButton;
     QLabel* playerLabel;
     QLabel* usernameLabel;
@@ -130,10 +148,11 @@ private:
     QHBoxLayout* gameMainLayout;
     QLabel* titleLabel;
     QLabel* statusLabel;
+    QLabel* searchStatsLabel;
     QLabel* playersLabel;
     QGridLayout* gameGridLayout;
     QWidget* gameGridWidget;
-    QPushButton* gameButtons[3][3];
+    QVector<QVector<BoardCell*>> gameButtons;
     QToolBar* toolBar;
     QAction* newGameAction;
     QAction* historyAction;
@@ -147,13 +166,21 @@ private:
     // Game Logic
     Board* board;
     AIPlayer* aiPlayer;
+    AsyncAIPlayer* asyncAI;
     QString currentPlayer;
     QString player1Name;
     QString player2Name;
     QString gameMode;
+    int boardSize;
+    int winLength;
     bool gameActive;
-    QStringList moveHistory;
+    MoveSequence moveHistory;
+    GameHistoryStore historyStore;
+    QJsonObject users;
+    // Declared after what its jobs touch, so it drains before they go away
+    PersistenceWriter persistence;
     QTimer* aiTimer;
+    QTimer* backgroundTimer;
 
     // Login Logic
     int currentStep;